@@ -46,11 +46,17 @@ int main() {
 
     // --- 3. Event Loop ---
     // The logic is simple: pass every character (that isn't the exit key)
-    // directly to the input box's `handle_input` method.
+    // directly to the input box's `handle_input` method. With bracketed paste
+    // on, pasted text arrives as a single PASTE event and goes in with one
+    // `insert_text` call.
+    kontra::terminal::set_bracketed_paste(true);
     kontra::run(screen, [&](const InputEvent& event) {
         if (event.type == EventType::KEY_PRESS) {
             input_box->handle_input(event.key);
         }
+        else if (event.type == EventType::PASTE) {
+            input_box->insert_text(event.text);
+        }
         });
 
     return 0;
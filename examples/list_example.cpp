@@ -40,16 +40,21 @@ int main() {
         std::make_shared<Border>(main_list)
     );
 
+    // Pasted text comes in as one PASTE event instead of a key press per byte.
+    kontra::terminal::set_bracketed_paste(true);
     kontra::run(screen, [&](const InputEvent& event) {
         switch (event.type) {
         case EventType::KEY_PRESS:
             input_item->handle_input(event.key);
             break;
+        case EventType::PASTE:
+            input_item->insert_text(event.text);
+            break;
         case EventType::MOUSE_SCROLL_UP:
-            main_list->scroll_up();
+            main_list->scroll_up(event.scroll_delta);
             break;
         case EventType::MOUSE_SCROLL_DOWN:
-            main_list->scroll_down();
+            main_list->scroll_down(event.scroll_delta);
             break;
         default:
             break;
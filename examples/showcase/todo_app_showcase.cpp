@@ -29,70 +29,71 @@ int main()
     auto input_box = std::make_shared<InputBox>();
     input_box->set_label("Enter todo!");
 
-    auto main_list = std::make_shared<List>();
-    // These vectors will be populated by the update_ui function
-    std::vector<std::shared_ptr<Text>> task_text_components;
+    auto main_layout = std::make_shared<Flex>(FlexDirection::Column);
     std::vector<std::shared_ptr<Button>> buttons;
 
     // --- 3. ACTIONS (Lambdas) ---
-    // Define the application logic first. These will be captured by the UI update function.
+    // Define the application logic first. These will be captured by the buttons.
     std::function<void()> add_task;
     std::function<void()> remove_task;
     std::function<void()> clear_tasks;
 
-    // --- 4. UI UPDATE FUNCTION ---
+    // --- 4. COMPONENTS ---
+    // Everything is built once. The task rows come straight from `tasks`: the virtual list
+    // only keeps a Text for each row on screen and fills them in every frame.
+    auto header_text = std::make_shared<Text>([&]()
+                                              { return (current_mode == AppMode::Editing)
+                                                           ? "EDITING | Enter: Add Task | Esc: Cancel"
+                                                           : "NAVIGATION | i: Insert | j/k: Nav | d: Del | Mouse"; }, 
+                                              TextStyle(ansi::FG_WHITE, ansi::BG_DEFAULT, true));
+
+    // --- REUSABLE BUTTON STYLES ---
+    auto add_style = ButtonStyleBuilder()
+        .set_inactive_style(StyleBuilder().set_color(ansi::FG_BLACK).set_background_color(ansi::BG_GREEN).set_bold(true).build())
+        .set_active_style(StyleBuilder().set_color(ansi::FG_WHITE).set_background_color(ansi::BG_BRIGHT_GREEN).set_bold(true).build())
+        .build();
+    
+    auto remove_style = ButtonStyleBuilder()
+        .set_inactive_style(StyleBuilder().set_color(ansi::FG_WHITE).set_background_color(ansi::BG_RED).set_bold(true).build())
+        .set_active_style(StyleBuilder().set_color(ansi::FG_WHITE).set_background_color(ansi::BG_BRIGHT_RED).set_bold(true).build())
+        .build();
+        
+    auto clear_style = ButtonStyleBuilder()
+        .set_inactive_style(StyleBuilder().set_color(ansi::FG_WHITE).set_background_color(ansi::BG_BRIGHT_BLACK).set_bold(true).build())
+        .set_active_style(StyleBuilder().set_color(ansi::FG_BLACK).set_background_color(ansi::BG_WHITE).set_bold(true).build())
+        .build();
+
+    // --- Create buttons and apply the new styles ---
+    auto add_button = std::make_shared<Button>(" Add ", [&]() { add_task(); }, add_style);
+    auto remove_button = std::make_shared<Button>(" Remove ", [&]() { remove_task(); }, remove_style);
+    auto clear_button = std::make_shared<Button>(" Clear All ", [&]() { clear_tasks(); }, clear_style);
+
+    buttons = {add_button, remove_button, clear_button};
+
+    auto button_bar = std::make_shared<Flex>(FlexDirection::Row, add_button, remove_button, clear_button);
+    button_bar->set_gap(1);
+
+    const TextStyle selected_style(ansi::FG_BLACK, ansi::BG_BRIGHT_WHITE, true);
+    const TextStyle task_style(ansi::FG_WHITE, "", false);
+    auto task_list = std::make_shared<VirtualList>(
+        [&]() { return tasks.size(); },
+        [&](Text& row, size_t i) {
+            row.set_text(tasks[i]).set_style(selected_task == static_cast<int>(i) ? selected_style : task_style);
+        });
+
+    // The controls keep their height and the task list takes what is left, so it has a
+    // bounded height to scroll in and scroll_to_row() can keep the selection on screen.
+    auto content = FlexItemBuilder().set_basis(FlexItem::AUTO).set_grow(0).set_shrink(0).build();
+    main_layout->add(header_text, content);
+    main_layout->add(input_box, content);
+    main_layout->add(button_bar, content);
+    main_layout->add(task_list);
+
+    // --- 5. UI UPDATE FUNCTION ---
     auto update_ui = [&]()
     {
         input_box->set_active(current_mode == AppMode::Editing);
-        main_list->clear();
-        task_text_components.clear();
-        buttons.clear();
-
-        auto header_text = std::make_shared<Text>([&]()
-                                                  { return (current_mode == AppMode::Editing)
-                                                               ? "EDITING | Enter: Add Task | Esc: Cancel"
-                                                               : "NAVIGATION | i: Insert | j/k: Nav | d: Del | Mouse"; }, 
-                                                  TextStyle(ansi::FG_WHITE, ansi::BG_DEFAULT, true));
-
-        // --- REUSABLE BUTTON STYLES ---
-        auto add_style = ButtonStyleBuilder()
-            .set_inactive_style(StyleBuilder().set_color(ansi::FG_BLACK).set_background_color(ansi::BG_GREEN).set_bold(true).build())
-            .set_active_style(StyleBuilder().set_color(ansi::FG_WHITE).set_background_color(ansi::BG_BRIGHT_GREEN).set_bold(true).build())
-            .build();
-        
-        auto remove_style = ButtonStyleBuilder()
-            .set_inactive_style(StyleBuilder().set_color(ansi::FG_WHITE).set_background_color(ansi::BG_RED).set_bold(true).build())
-            .set_active_style(StyleBuilder().set_color(ansi::FG_WHITE).set_background_color(ansi::BG_BRIGHT_RED).set_bold(true).build())
-            .build();
-            
-        auto clear_style = ButtonStyleBuilder()
-            .set_inactive_style(StyleBuilder().set_color(ansi::FG_WHITE).set_background_color(ansi::BG_BRIGHT_BLACK).set_bold(true).build())
-            .set_active_style(StyleBuilder().set_color(ansi::FG_BLACK).set_background_color(ansi::BG_WHITE).set_bold(true).build())
-            .build();
-
-        // --- Create buttons and apply the new styles ---
-        auto add_button = std::make_shared<Button>(" Add ", add_task, add_style);
-        auto remove_button = std::make_shared<Button>(" Remove ", remove_task, remove_style);
-        auto clear_button = std::make_shared<Button>(" Clear All ", clear_tasks, clear_style);
-
-        buttons = {add_button, remove_button, clear_button};
-
-        auto button_bar = std::make_shared<Flex>(FlexDirection::Row, add_button, remove_button, clear_button);
-        button_bar->set_gap(1);
-
-        main_list->add(header_text);
-        main_list->add(input_box);
-        main_list->add(button_bar);
-
-        for (size_t i = 0; i < tasks.size(); ++i)
-        {
-            auto style = (selected_task == static_cast<int>(i))
-                             ? TextStyle(ansi::FG_BLACK, ansi::BG_BRIGHT_WHITE, true)
-                             : TextStyle(ansi::FG_WHITE, "", false);
-            auto txt = std::make_shared<Text>(tasks[i], style);
-            main_list->add(txt);
-            task_text_components.push_back(txt);
-        }
+        if (selected_task >= 0) task_list->scroll_to_row(selected_task);
     };
 
     // --- Now define the implementation of the actions ---
@@ -130,13 +131,13 @@ int main()
         update_ui();
     };
 
-    update_ui(); // Initial UI draw
+    update_ui(); // Initial UI state
 
-    // --- 5. LAYOUT ---
-    main_list->set_gap(1);
+    // --- 6. LAYOUT ---
+    main_layout->set_gap(1);
     auto screen = std::make_shared<Screen>(
         chain(std::make_shared<Border>(
-                  main_list,
+                  main_layout,
                   BorderStyleBuilder()
                       .set_title("tOdO!!!")
                       .set_characters(BorderPreset::DOUBLE)
@@ -145,7 +146,9 @@ int main()
               [](Border &b)
               { b.set_padding(1); }));
 
-    // --- 6. EVENT LOOP ---
+    // --- 7. EVENT LOOP ---
+    // Pasted text comes in as one PASTE event instead of a key press per byte.
+    kontra::terminal::set_bracketed_paste(true);
     kontra::run(screen, [&](const InputEvent &event)
     {
         if (current_mode == AppMode::Editing) {
@@ -157,6 +160,9 @@ int main()
                     current_mode = AppMode::Navigating; 
                     update_ui(); 
                     break;
+                case EventType::PASTE:
+                    input_box->insert_text(event.text);
+                    break;
                 default: 
                     input_box->handle_input(event.key); 
                     break;
@@ -199,12 +205,13 @@ int main()
                     else if (buttons[1]->contains(event.mouse_x, event.mouse_y)) remove_task();
                     else if (buttons[2]->contains(event.mouse_x, event.mouse_y)) clear_tasks();
                     else {
-                        for (size_t i = 0; i < task_text_components.size(); ++i) { if (task_text_components[i]->contains(event.mouse_x, event.mouse_y)) { selected_task = i; update_ui(); return; } }
+                        long long row = task_list->row_at(event.mouse_x, event.mouse_y);
+                        if (row >= 0) { selected_task = static_cast<int>(row); update_ui(); return; }
                         if (input_box->contains(event.mouse_x, event.mouse_y)) { current_mode = AppMode::Editing; update_ui(); }
                     }
                     break;
-                case EventType::MOUSE_SCROLL_UP:   main_list->scroll_up();   break;
-                case EventType::MOUSE_SCROLL_DOWN: main_list->scroll_down(); break;
+                case EventType::MOUSE_SCROLL_UP:   task_list->scroll_up(event.scroll_delta);   break;
+                case EventType::MOUSE_SCROLL_DOWN: task_list->scroll_down(event.scroll_delta); break;
                 default: break;
             }
         }
@@ -14,6 +14,7 @@
 #include <memory>
 #include <chrono> // For getting the current time
 #include <ctime>  // For formatting the time
+#include <thread> // For the ticker that keeps the clock moving
 
 int main() {
     // --- 1. Create a Static Text Component ---
@@ -82,6 +83,18 @@ int main() {
 
     // --- 5. Screen and Run ---
     auto screen = std::make_shared<Screen>(bordered_layout);
+    // Only the clock changes from frame to frame, so let the screen keep the rest as it is.
+    screen->set_retained(true);
+
+    // Kontra only redraws when something happens. Nothing happens to a clock,
+    // so a small ticker asks for a redraw once a second.
+    std::thread ticker([]() {
+        while (true) {
+            std::this_thread::sleep_for(std::chrono::seconds(1));
+            kontra::invalidate();
+        }
+        });
+    ticker.detach();
 
     kontra::run(screen, [&](const InputEvent& event) {
         // Static example, no input needed.
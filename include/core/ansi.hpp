@@ -57,6 +57,16 @@ namespace ansi {
 	inline constexpr const char* HIDE_CURSOR = "\033[?25l";
 	inline constexpr const char* SHOW_CURSOR = "\033[?25h";
 
+	// Synchronized output (DEC private mode 2026). The terminal holds off repainting
+	// between BEGIN and END, so a frame shows up all at once instead of torn.
+	inline constexpr const char* BEGIN_SYNCHRONIZED_UPDATE = "\033[?2026h";
+	inline constexpr const char* END_SYNCHRONIZED_UPDATE = "\033[?2026l";
+	inline constexpr const char* QUERY_SYNCHRONIZED_UPDATE = "\033[?2026$p"; // DECRQM, answered with \033[?2026;N$y
+
+	// Bracketed paste: pasted text arrives between \033[200~ and \033[201~ instead of as typing.
+	inline constexpr const char* ENABLE_BRACKETED_PASTE = "\033[?2004h";
+	inline constexpr const char* DISABLE_BRACKETED_PASTE = "\033[?2004l";
+
 	// Screen clearing
 	inline constexpr const char* CLEAR_TO_END = "\033[J";
 	inline constexpr const char* CLEAR_TO_START = "\033[1J";
@@ -98,6 +98,7 @@ public:
 	 */
 	explicit Border(std::shared_ptr<Component> child_component, const BorderStyle& style = BorderStyle())
 		: child(child_component), padding(0), style(style) {
+		adopt(child.get());
 	}
 
 	/**
@@ -113,6 +114,8 @@ public:
 	 */
 	Border() : child(nullptr), padding(0), style() {}
 
+	~Border() override { release_children(); }
+
 
 	/**
 	 * @brief Sets the padding of the Border component.
@@ -130,6 +133,16 @@ public:
 
 	int get_preferred_height(int width) const override;
 
+	// See core/component.hpp
+	bool caches_layout() const override { return true; }
+
+	int get_preferred_width() const override;
+
+	// See core/component.hpp
+	size_t child_count() const override { return child ? 1 : 0; }
+	Component* child_at(size_t index) const override { return child.get(); }
+	Cell backdrop() const override;
+
 	/**
 	 * @brief Renders the border at the specified position and size.
 	 * @param x The x-coordinate of the input box's position.
@@ -39,7 +39,11 @@ class Box : public Component {
     int fixed_height = -1; // -1 means no constraint
 
 public:
-    explicit Box(std::shared_ptr<Component> child_component) : child(child_component) {}
+    explicit Box(std::shared_ptr<Component> child_component) : child(child_component) {
+        adopt(child.get());
+    }
+
+    ~Box() override { release_children(); }
 
     /**
 	 * \brief Sets the width of the box and its child component.
@@ -47,6 +51,7 @@ public:
      */
     Box& set_width(int w) {
         fixed_width = w;
+        invalidate_layout();
         return *this;
     }
 
@@ -56,11 +61,21 @@ public:
      */
     Box& set_height(int h) {
         fixed_height = h;
+        invalidate_layout();
         return *this;
     }
 
     int get_preferred_height(int width) const override;
 
+    // See core/component.hpp
+    bool caches_layout() const override { return true; }
+
+    int get_preferred_width() const override;
+
+    // See core/component.hpp
+    size_t child_count() const override { return child ? 1 : 0; }
+    Component* child_at(size_t index) const override { return child.get(); }
+
     /**
      * @brief Renders the box at the specified position and size.
      * @param x The x-coordinate of the input box's position.
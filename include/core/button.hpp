@@ -85,7 +85,7 @@ struct ButtonStyleBuilder {
  */
 class Button : public Component {
 private:
-	std::function<std::string()> label_provider;
+	Text label_text; // kept between frames, so its layout and style are only worked out when they change
 	bool active;
 	std::function<void()> on_click_callback;
 	ButtonStyle style;
@@ -94,19 +94,22 @@ public:
 
 	// For normal text labels
 	Button(std::string label, std::function<void()> on_click_callback, const ButtonStyle& style = ButtonStyle())
-		: label_provider([label]() { return label; }),
+		: label_text(label),
 		  on_click_callback(std::move(on_click_callback)),
 		  active(false),
 		  style(style) {
+		adopt(&label_text);
 	}
 
 
 	// For dynamic text labels
 	Button(std::function<std::string()> provider, std::function<void()> on_click_callback, const ButtonStyle& style = ButtonStyle()) 
-        : label_provider(std::move(provider)), 
+        : label_text(std::move(provider)), 
           on_click_callback(std::move(on_click_callback)), 
           active(false), 
-          style(style) {}
+          style(style) {
+		adopt(&label_text);
+	}
 
 	/**
 	 * @brief Sets the active state of the button. An active button typically
@@ -140,7 +143,16 @@ public:
      * @param width The available width for the component.
      * @return The required height in terminal rows.
      */
-	int get_preferred_height(int width) const override; 
+	int get_preferred_height(int width) const override;
+
+	// See core/component.hpp
+	bool caches_layout() const override { return true; }
+
+	int get_preferred_width() const override { return label_text.get_preferred_width(); }
+
+	// See core/component.hpp
+	size_t child_count() const override { return 1; }
+	Component* child_at(size_t index) const override { return const_cast<Text*>(&label_text); }
 
 	/**
 	 * @brief Renders the button at the specified position and size.
@@ -62,17 +62,24 @@ struct CheckboxStyleBuilder {
  */
 class Checkbox : public Component {
 private:
-	std::function<std::string()> label_provider;
+	// Kept between frames: "[x] " or "[ ] ", and the label next to it.
+	Text marker;
+	Text label_text;
 	bool active;
 	bool* target_variable;
+	bool drawn_checked = false; // *target_variable as of the last render
 	CheckboxStyle style;
 
 public:
 	Checkbox(std::string label, bool* target, const CheckboxStyle& style = CheckboxStyle())
-		: label_provider([label]() { return label; }),
+		: marker("[ ] "),
+		  label_text(label),
 		  target_variable(target),
 		  active(false),
 		  style(style) {
+		adopt(&marker);
+		adopt(&label_text);
+		set_polling(target != nullptr);
 	}
 	/**
 	 * @brief Sets is_active state
@@ -94,7 +101,19 @@ public:
 	 */
 	void toggle();
 
-	int get_preferred_height(int width) const override; 
+	int get_preferred_height(int width) const override;
+
+	// See core/component.hpp
+	bool caches_layout() const override { return true; }
+
+	int get_preferred_width() const override { return 4 + label_text.get_preferred_width(); }
+
+	// See core/component.hpp, notices the bound variable changing behind the checkbox's back.
+	bool poll() override;
+
+	// See core/component.hpp
+	size_t child_count() const override { return 2; }
+	Component* child_at(size_t index) const override { return const_cast<Text*>(index == 0 ? &marker : &label_text); }
 
 	/**
 	 * @brief Renders the checkbox at the specified position and size.
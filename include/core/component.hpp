@@ -3,7 +3,10 @@
  * \brief  The base class for all components in the terminal UI.
  *********************************************************************/
 #pragma once
+#include <cstddef>
+#include <cstdint>
 #include <iostream>
+#include <utility>
 #include "core/screen_buffer.hpp"
 
 class Component
@@ -13,17 +16,157 @@ public:
     virtual ~Component() = default;
 
     /**
-     * Renders the component. The component itself will determine if a redraw
-     * is necessary by comparing the new state (x,y,w,h, content) to its
-     * last rendered state.
+     * Counts frames, bumped by Screen::render before anything is drawn. Components use it
+     * to do expensive work (like calling a text provider) once per frame instead of once
+     * per call.
+     */
+    static inline std::uint64_t frame_epoch = 0;
+
+    /// The container this component was added to, null for the root (and until it is added).
+    Component* parent = nullptr;
+
+    /**
+     * Renders the component into the rectangle it is given. Every override calls this first,
+     * it records the rectangle (for contains() and for redrawing in place later on).
      */
     virtual void render(ScreenBuffer& buffer, int x, int y, int w, int h) {
         this->last_x = x;
         this->last_y = y;
         this->last_w = w;
         this->last_h = h;
+        this->painted_frame = frame_epoch;
+    }
+
+    /**
+     * \brief Asks for the component to be drawn again on the next retained frame.
+     *
+     * Built-in widgets call this from their own setters. Call it yourself after changing
+     * something a component reads through a pointer or callback that it cannot notice on its
+     * own. Every ancestor is told that something below it changed, so the retained pass only
+     * walks down the branches that lead to a change.
+     */
+    void mark_dirty() {
+        dirty = true;
+        for (Component* c = parent; c && !c->child_dirty; c = c->parent) {
+            c->child_dirty = true;
+        }
+    }
+
+    /// True if the component has changed since it was last drawn in retained mode.
+    bool is_dirty() const { return dirty; }
+
+    /**
+     * \brief The preferred height for `width`, worked out once and then kept until the width
+     * or the component's content changes.
+     *
+     * Containers measure their children through this instead of calling
+     * get_preferred_height() directly, so measuring a deep tree costs one get_preferred_height()
+     * per component, not one per ancestor. Components that do not caches_layout() are
+     * measured again on every call.
+     */
+    int measure(int width) const {
+        if (!caches_layout()) return get_preferred_height(width);
+        if (measured_width != width || measured_generation != layout_generation) {
+            measured_height = get_preferred_height(width);
+            measured_width = width;
+            // Read after measuring: a text provider called in there may have bumped it.
+            measured_generation = layout_generation;
+        }
+        return measured_height;
+    }
+
+    /**
+     * \brief Throws away the measurements and arrangements of this component and of every
+     * ancestor, because its size may have changed. Also marks it dirty.
+     *
+     * Widgets call it when their content changes. Call it yourself after changing something
+     * that decides the preferred height of a custom component.
+     */
+    void invalidate_layout() {
+        drop_layout();
+        mark_dirty();
     }
 
+    /**
+     * \brief Whether this component calls invalidate_layout() every time its preferred height
+     * may change, so its measurement (and its ancestors' arrangements) can be kept between frames.
+     *
+     * Built-in widgets do. A custom component is measured again on every frame, as it always
+     * was, unless it overrides this to return true. One derived from a built-in widget that
+     * sizes itself from outside state should override it to return false.
+     */
+    virtual bool caches_layout() const { return false; }
+
+    /// Changes whenever invalidate_layout() reaches this component. Containers compare it
+    /// against the value they arranged their children for.
+    std::uint64_t get_layout_generation() const { return layout_generation; }
+
+    /**
+     * \brief Lets every component that reads outside state (text providers, bound variables)
+     * check it, before anything is measured or drawn. Screen does this at the start of every frame.
+     *
+     * Components whose poll() saw a change are marked dirty, and the ones whose size may have
+     * changed drop their measurements, so the frame lays out with fresh sizes.
+     */
+    void refresh();
+
+    /**
+     * \brief Brings this component's part of `buffer` up to date, redrawing only what changed.
+     *
+     * `buffer` must still hold what the last frame drew. A dirty component is cleared and
+     * rendered again in the rectangle it had last time, a clean one is left alone and only its
+     * children are looked at, and a clean subtree with no changes below it is skipped without
+     * being visited. Screen::update() is what calls this.
+     *
+     * \return True if anything was drawn.
+     */
+    bool repaint(ScreenBuffer& buffer);
+
+    /// Marks the subtree drawn by the last render as clean.
+    void settle();
+
+    /// Number of children, for walking the tree. Containers override this and child_at().
+    virtual size_t child_count() const { return 0; }
+
+    /// Child number `index`, less than child_count().
+    virtual Component* child_at(size_t index) const { return nullptr; }
+
+    /**
+     * \brief The children [first, second) that the last render may have drawn. repaint() and
+     * settle() only look at these, so a List showing 30 of 300k children costs 30 per frame.
+     * Containers that draw only some of their children narrow it.
+     */
+    virtual std::pair<size_t, size_t> drawn_children() const { return { 0, child_count() }; }
+
+    /**
+     * \brief Checks state the component reads from outside (a text provider, a bound variable)
+     * and returns true if it changed since the component was last drawn. If the change can
+     * affect its size, it calls invalidate_layout() as well.
+     *
+     * Called by refresh() on every frame for components that enabled polling, so keep it cheap.
+     */
+    virtual bool poll() { return false; }
+
+    /**
+     * \brief Whether a change in `child` means this component has to lay out its children
+     * again, instead of the child simply being redrawn in place. Containers that size children
+     * by their preferred height say yes when that height changed.
+     */
+    virtual bool child_needs_layout(const Component& child) const { return false; }
+
+    /**
+     * \brief Whether children this component did not draw last time changed in a way that
+     * moves the ones it did, so it has to be laid out again. A List says yes when a row
+     * scrolled out of view changed its height.
+     */
+    virtual bool layout_moved() const { return false; }
+
+    /**
+     * \brief The cell this component paints behind its children, used to clear a child before
+     * it is redrawn on its own. Components without a background pass their parent's on.
+     */
+    virtual Cell backdrop() const { return parent ? parent->backdrop() : Cell(); }
+
     /**
 	 * \brief Checks if the component contains the given mouse coordinates, for handling mouse events.
 	 * \param mouse_x The x-coordinate of the mouse event.
@@ -45,7 +188,61 @@ public:
 	 */
     virtual int get_preferred_height(int width) const { return 1; }
 
+    /**
+     * Returns the width the component needs to show everything without wrapping, or 0 if it
+     * has no preference and takes whatever it is given. Auto sized Grid columns and Row Flex
+     * children with an AUTO basis are sized by it.
+     */
+    virtual int get_preferred_width() const { return 0; }
+
 protected:
+    /**
+     * Makes `child` a child of this component: its size changes invalidate this component's
+     * layout, and its dirty flag reaches the retained pass. Containers call it for every child
+     * they are given.
+     */
+    void adopt(Component* child) {
+        if (!child) return;
+        child->parent = this;
+        // refresh() has to reach components that are measured every frame.
+        if (!child->caches_layout()) child->polls_below = true;
+        if (child->polls_below) {
+            for (Component* c = this; c && !c->polls_below; c = c->parent) c->polls_below = true;
+        }
+        invalidate_layout();
+    }
+
+    /// adopt() for every child, for containers that were handed all their children at once.
+    void adopt_children() {
+        for (size_t i = 0, n = child_count(); i < n; ++i) adopt(child_at(i));
+    }
+
+    /**
+     * refresh() for the children, all of them by default. Containers that only measure and
+     * draw some of their children (a virtualized List) refresh just those, and refresh the
+     * others themselves when they come into view.
+     */
+    virtual void refresh_children();
+
+    /// Components whose poll() can return true turn this on, so refresh() visits them.
+    void set_polling(bool enabled) {
+        polls = enabled;
+        if (enabled) {
+            for (Component* c = this; c && !c->polls_below; c = c->parent) c->polls_below = true;
+        }
+    }
+
+    /**
+     * Unlinks the children from this component. Containers call it from their destructor and
+     * when their children are removed, so no child is left pointing at a parent that is gone.
+     */
+    void release_children() {
+        for (size_t i = 0, n = child_count(); i < n; ++i) {
+            Component* child = child_at(i);
+            if (child && child->parent == this) child->parent = nullptr;
+        }
+    }
+
     /**
      * Helper function to clear a rectangular area of the terminal.
      * Every component will use this to erase its old self.
@@ -59,4 +256,25 @@ protected:
             }
         }
     }
+
+private:
+    bool dirty = true;        // this component has to be rendered again
+    bool child_dirty = true;  // something below it has
+    bool polls = false;       // poll() can report changes
+    bool polls_below = false; // this component or something below it polls
+    std::uint64_t painted_frame = 0; // frame_epoch of the last render
+
+    std::uint64_t layout_generation = 0;
+    mutable std::uint64_t measured_generation = 0;
+    mutable int measured_width = -1; // -1 until measured
+    mutable int measured_height = 0;
+
+    void redraw(ScreenBuffer& buffer);
+
+    // Bumps the layout generation of this component and every ancestor.
+    void drop_layout() {
+        for (Component* c = this; c; c = c->parent) {
+            c->layout_generation++;
+        }
+    }
 };
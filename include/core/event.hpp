@@ -6,6 +6,7 @@
  * \date   June 2025
  *********************************************************************/
 #pragma once
+#include <string>
 
 /**
  * @brief It defines all sorts of events that can be generated by the user. This includes both keyboard and mouse events.
@@ -22,6 +23,8 @@ enum class EventType {
     MOUSE_SCROLL_UP,
     MOUSE_SCROLL_DOWN,
     MOUSE_PRESS, 
+    MOUSE_MOVE,
+    PASTE,
     QUIT,
     UNKNOWN
 };
@@ -44,4 +47,26 @@ struct InputEvent {
     char key = 0;      
     int mouse_x = -1;  
     int mouse_y = -1;  
+    /// Wheel steps for MOUSE_SCROLL_UP / MOUSE_SCROLL_DOWN. A fast flick arrives as one event with a bigger delta.
+    int scroll_delta = 0;
+    /// The pasted text for PASTE, in one piece no matter how big. Line breaks are always '\n'.
+    std::string text;
+
+    /// A keyboard event, or any event that only has a type. Set the fields one by one
+    /// instead of brace initializing, so adding a field does not touch every event made.
+    static InputEvent keyboard(EventType type, char key = 0) {
+        InputEvent event;
+        event.type = type;
+        event.key = key;
+        return event;
+    }
+
+    /// A mouse event at 1-based terminal coordinates. `button` goes in `key`.
+    static InputEvent mouse(EventType type, char button, int x, int y, int scroll_delta = 0) {
+        InputEvent event = keyboard(type, button);
+        event.mouse_x = x;
+        event.mouse_y = y;
+        event.scroll_delta = scroll_delta;
+        return event;
+    }
 };
@@ -0,0 +1,67 @@
+/*****************************************************************//**
+ * \file   fenwick_tree.hpp
+ * \brief  Running totals over a list of numbers that stay cheap to update and search.
+ *
+ * A virtualized List needs to know where row N starts (the sum of every height before
+ * it) and which item a scroll offset lands in. Recomputing that by walking the items is
+ * O(n) per frame, which is far too slow for a list with a few hundred thousand rows.
+ *
+ * A Fenwick (binary indexed) tree answers both questions in O(log n), and changing one
+ * item's value or appending a new one is O(log n) too.
+ *
+ * \author parv141206
+ * \date   October 2026
+ *********************************************************************/
+#pragma once
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief Prefix sums over non-negative ints, with point updates and offset search.
+ *
+ * Example:
+ * ```cpp
+ * FenwickTree heights;
+ * heights.assign({ 1, 3, 2 });
+ * heights.prefix(2);      // 4, the rows above item 2
+ * heights.find(3);        // 1, row 3 lies inside item 1
+ * heights.set(0, 5);      // item 0 grew, everything after it moves down
+ * ```
+ */
+class FenwickTree {
+public:
+	/// Replaces all values, in O(n).
+	void assign(const std::vector<int>& new_values);
+
+	/// Appends a value at the end.
+	void push_back(int value);
+
+	/// Changes the value at `index`.
+	void set(size_t index, int value);
+
+	/// Removes every value.
+	void clear() { values.clear(); tree.assign(1, 0); }
+
+	/// The value at `index`.
+	int get(size_t index) const { return values[index]; }
+
+	size_t size() const { return values.size(); }
+	bool empty() const { return values.empty(); }
+
+	/// Sum of the first `count` values.
+	long long prefix(size_t count) const;
+
+	/// Sum of every value.
+	long long total() const { return prefix(values.size()); }
+
+	/**
+	 * \brief The index whose span [prefix(i), prefix(i + 1)) contains `offset`.
+	 * \return size() if `offset` is at or past the total.
+	 */
+	size_t find(long long offset) const;
+
+private:
+	// tree[i] (1-based) holds the sum of the values (i - lowbit(i), i].
+	std::vector<long long> tree = std::vector<long long>(1, 0);
+	std::vector<int> values;
+};
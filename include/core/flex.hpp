@@ -3,13 +3,22 @@
  * \brief  A Flex component that arranges its children in a row or column.
  * It acts as a container for other components, allowing them to be laid out.
  *
- * todo: Obviously adding more features like spacing, alignment, etc. would be useful.
+ * Space along the direction is handed out like CSS flexbox: every child starts at its
+ * basis, then the space left over is shared by the children that grow, or the space
+ * missing is taken from the ones that shrink, in proportion to their factors and within
+ * their min/max. A child pushed past its min or max is held there and the rest share again,
+ * so that is one more pass per clamped child, without limits it is a single linear pass.
+ *
+ * The default item (grow 1, basis 0) splits the space equally, as a plain Flex always did,
+ * except that cells which do not divide evenly now go to the first children instead of
+ * being left empty.
  *
  * \author parv141206
  * \date   June 2025
  *********************************************************************/
 #pragma once
 #include "component.hpp"
+#include <climits>
 #include <vector>
 #include <memory>
 
@@ -18,6 +27,59 @@ enum class FlexDirection {
 	Column
 };
 
+/// Where children go across the direction (vertically in a Row).
+enum class FlexAlign {
+	Stretch, ///< Fill the whole height. The default.
+	Start,
+	Center,
+	End
+};
+
+/// Where the space nobody grew into goes along the direction.
+enum class FlexJustify {
+	Start,
+	Center,
+	End,
+	SpaceBetween
+};
+
+/// @brief How one child of a Flex is sized along the direction. Create this with a FlexItemBuilder.
+struct FlexItem {
+	/// A basis of AUTO means the child's preferred size: its height in a Column, its
+	/// get_preferred_width() in a Row.
+	static constexpr int AUTO = -1;
+
+	int grow = 1;    ///< Share of the leftover space this child takes, 0 to keep its basis.
+	int shrink = 1;  ///< How readily it gives up space when there is not enough, 0 to never shrink.
+	int basis = 0;   ///< Size before growing or shrinking, in cells, or AUTO.
+	int min = 0;
+	int max = INT_MAX;
+};
+
+/**
+ * @brief Fluent builder for FlexItem.
+ *
+ * A header that is always 3 rows, a body that takes the rest and a footer sized to its content:
+ * ```cpp
+ * auto fixed = FlexItemBuilder().set_basis(3).set_grow(0).set_shrink(0).build();
+ * auto content = FlexItemBuilder().set_basis(FlexItem::AUTO).set_grow(0).build();
+ *
+ * auto layout = std::make_shared<Flex>(FlexDirection::Column);
+ * layout->add(header, fixed);
+ * layout->add(body);
+ * layout->add(footer, content);
+ * ```
+ */
+struct FlexItemBuilder {
+	FlexItem item;
+	FlexItemBuilder& set_grow(int grow) { item.grow = grow; return *this; }
+	FlexItemBuilder& set_shrink(int shrink) { item.shrink = shrink; return *this; }
+	FlexItemBuilder& set_basis(int basis) { item.basis = basis; return *this; }
+	FlexItemBuilder& set_min(int min) { item.min = min; return *this; }
+	FlexItemBuilder& set_max(int max) { item.max = max; return *this; }
+	FlexItem build() const { return item; }
+};
+
 /**
  * @brief A Flex component that arranges its children in a row or column.
  * 
@@ -37,25 +99,55 @@ enum class FlexDirection {
  */
 class Flex : public Component {
 	std::vector<std::shared_ptr<Component>> children;
+	std::vector<FlexItem> items; // one per child
 	FlexDirection direction;
 	int gap;
 	int padding;
+	FlexAlign align = FlexAlign::Stretch;
+	FlexJustify justify = FlexJustify::Start;
+
+	// Where each child goes, relative to the Flex's top-left corner. Worked out by arrange()
+	// for one size and kept until the size or the layout generation changes.
+	struct Slot {
+		int x, y, w, h;
+	};
+	std::vector<Slot> slots;
+	int arranged_w = -1, arranged_h = -1;
+	std::uint64_t arranged_generation = 0;
+
+	// Scratch space for solve(), kept so solving does not allocate. `sizes` holds the result.
+	mutable std::vector<int> bases;
+	mutable std::vector<int> sizes;
+	mutable std::vector<int> targets;
+	mutable std::vector<char> frozen;
+
+	void arrange(int w, int h);
+	int basis_of(size_t index, int cross) const;
+	int solve(int available, int cross) const;
 
 public:
 	template <typename... T>
 	Flex(FlexDirection dir, T&&... comps)
 		: direction(dir), gap(0), padding(0) {
 		add_components(std::forward<T>(comps)...);
+		items.resize(children.size());
+		adopt_children();
 	}
 
 	Flex(FlexDirection dir, std::vector<std::shared_ptr<Component>>&& comps)
-		: direction(dir), children(std::move(comps)), gap(0), padding(0) {
+		: children(std::move(comps)), direction(dir), gap(0), padding(0) {
+		items.resize(children.size());
+		adopt_children();
 	}
 
 	Flex(FlexDirection dir, const std::vector<std::shared_ptr<Component>>& comps)
-		: direction(dir), children(comps), gap(0), padding(0) {
+		: children(comps), direction(dir), gap(0), padding(0) {
+		items.resize(children.size());
+		adopt_children();
 	}
 
+	~Flex() override { release_children(); }
+
 
 	/**
 	 * \brief Adds a component to the layout.
@@ -63,6 +155,29 @@ public:
 	 */
 	void add(std::shared_ptr<Component> comp);
 
+	/**
+	 * \brief Adds a component that is sized by `item` instead of the default.
+	 * \param comp The component to add
+	 * \param item Its grow, shrink, basis, min and max
+	 */
+	void add(std::shared_ptr<Component> comp, const FlexItem& item);
+
+	/**
+	 * \brief Changes how the child at `index` is sized.
+	 * \param index The child, in the order they were added
+	 * \param item Its grow, shrink, basis, min and max
+	 */
+	Flex& set_item(size_t index, const FlexItem& item);
+
+	/**
+	 * \brief Sets where children go across the direction. Anything but Stretch sizes them
+	 * to their content: the preferred height in a Row, the preferred width in a Column.
+	 */
+	Flex& set_align(FlexAlign a);
+
+	/// Sets where leftover space goes when no child grows into it.
+	Flex& set_justify(FlexJustify j);
+
 	/**
 	 * \brief Sets the gap between children
 	 * \param g the gap to add
@@ -78,6 +193,18 @@ public:
 	/// Clears all children from the layout.
 	void clear();
 
+	/**
+	 * \brief The height the children want: in a Column the sum of their bases (or content,
+	 * for children that grow), in a Row the tallest child at the width it would get.
+	 */
+	int get_preferred_height(int width) const override;
+
+	// See core/component.hpp
+	bool caches_layout() const override { return true; }
+	size_t child_count() const override { return children.size(); }
+	Component* child_at(size_t index) const override { return children[index].get(); }
+	bool child_needs_layout(const Component& child) const override;
+
 	/**
 	 * \brief Renders the component at the specified position and size.
 	 * \param x The x-coordinate of the component's position.
@@ -0,0 +1,90 @@
+/*****************************************************************//**
+ * \file   frame_scheduler.hpp
+ * \brief  Decides when the run loop is allowed to draw the next frame.
+ *
+ * By default frames are only drawn when something asked for one (input, a resize or
+ * kontra::invalidate()), and never closer together than the minimum frame interval, so a
+ * flood of events still turns into at most ~60 frames a second.
+ *
+ * With a target FPS the loop draws continuously, which is what animations want. Frames
+ * are paced against deadlines measured from when the previous frame *started*, so time
+ * spent rendering is subtracted from the wait instead of being added on top of it.
+ *
+ * \author parv141206
+ * \date   October 2026
+ *********************************************************************/
+#pragma once
+#include <chrono>
+
+/**
+ * @brief Whether frames are wrapped in synchronized output (DEC mode 2026) sequences.
+ */
+enum class SynchronizedOutput {
+	AUTO,   ///< Ask the terminal at startup, and only wrap frames if it says it supports the mode.
+	ALWAYS, ///< Always wrap. Terminals that do not know the mode ignore it.
+	NEVER,  ///< Never wrap.
+};
+
+/**
+ * @brief Frame pacing settings and state for kontra::run().
+ *
+ * Example:
+ * ```cpp
+ * // Smooth 60 FPS animation.
+ * kontra::run(screen, on_input, FrameScheduler().set_target_fps(60));
+ *
+ * // A background pane that should barely use any CPU.
+ * kontra::run(screen, on_input, FrameScheduler().set_min_frame_interval(std::chrono::milliseconds(250)));
+ * ```
+ */
+class FrameScheduler {
+public:
+	using Clock = std::chrono::steady_clock;
+
+	/**
+	 * \brief Draws continuously at this many frames per second. 0 (the default) means
+	 * frames are only drawn on demand.
+	 */
+	FrameScheduler& set_target_fps(int fps);
+
+	/**
+	 * \brief The shortest time allowed between the start of two frames. Defaults to 16ms.
+	 * Requests that arrive sooner are merged into the next frame.
+	 */
+	FrameScheduler& set_min_frame_interval(std::chrono::milliseconds interval);
+
+	/**
+	 * \brief Whether each frame is sent as one synchronized update, so the terminal shows it
+	 * all at once instead of repainting halfway through a big diff. Defaults to AUTO.
+	 */
+	FrameScheduler& set_synchronized_output(SynchronizedOutput mode) { sync_mode = mode; return *this; }
+
+	int get_target_fps() const { return target_fps; }
+	std::chrono::milliseconds get_min_frame_interval() const { return min_interval; }
+	SynchronizedOutput get_synchronized_output() const { return sync_mode; }
+
+	/// Asks for a frame. Any number of requests before the next frame result in one frame.
+	void request_frame() { requested = true; }
+
+	/// True if a frame should be drawn right now.
+	bool frame_due(Clock::time_point now) const;
+
+	/**
+	 * \brief How long the loop can sleep before the next frame is due.
+	 * \return Milliseconds to wait, or -1 if no frame is pending and the loop can sleep until woken.
+	 */
+	int wait_timeout_ms(Clock::time_point now) const;
+
+	/// Called by the loop when it starts drawing a frame. Clears requests and sets the next deadline.
+	void begin_frame(Clock::time_point now);
+
+private:
+	Clock::duration period() const;
+
+	int target_fps = 0;
+	std::chrono::milliseconds min_interval{ 16 };
+	SynchronizedOutput sync_mode = SynchronizedOutput::AUTO;
+
+	bool requested = false;
+	Clock::time_point next_frame{}; // earliest start of the next frame
+};
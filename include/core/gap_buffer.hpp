@@ -0,0 +1,107 @@
+/*****************************************************************//**
+ * \file   gap_buffer.hpp
+ * \brief  Editable text storage where typing at the cursor does not move the rest of the text.
+ *
+ * The text lives in one array with a hole (the gap) at the edit position. Inserting fills
+ * the gap, erasing widens it, and only moving the edit position somewhere else shifts the
+ * characters in between. Typing and backspacing at the cursor is O(1) amortized no matter
+ * how long the text is, where a std::string shifts the whole tail every time.
+ *
+ * The buffer also keeps the positions of every '\n', so line counts and wrap heights can
+ * be worked out per line instead of per character.
+ *
+ * \author parv141206
+ * \date   October 2026
+ *********************************************************************/
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief A gap buffer of chars with a line break index.
+ *
+ * Example:
+ * ```cpp
+ * GapBuffer text;
+ * text.insert(0, "hello");
+ * text.insert(5, " world");
+ * text.erase(0, 1);
+ * std::string_view all = text.view(); // "ello world"
+ * ```
+ */
+class GapBuffer {
+public:
+	GapBuffer() = default;
+	explicit GapBuffer(std::string_view initial) { assign(initial); }
+
+	/// Number of characters, not counting the gap.
+	size_t size() const { return storage.size() - gap_size(); }
+	bool empty() const { return size() == 0; }
+
+	/// Character at `pos`, which must be less than size().
+	char operator[](size_t pos) const { return pos < gap_begin ? storage[pos] : storage[pos + gap_size()]; }
+
+	/// Inserts `s` before position `pos` (clamped to size()).
+	void insert(size_t pos, std::string_view s);
+
+	/// Inserts a single character before position `pos`.
+	void insert(size_t pos, char ch) { insert(pos, std::string_view(&ch, 1)); }
+
+	/// Erases up to `count` characters starting at `pos`.
+	void erase(size_t pos, size_t count);
+
+	/// Replaces the whole content.
+	void assign(std::string_view s);
+
+	/**
+	 * \brief The whole text as one contiguous view, valid until the next edit.
+	 *
+	 * This moves the gap to the end, which is free when the last edit was at the end (the
+	 * usual case while typing) and O(distance) otherwise.
+	 */
+	std::string_view view() const;
+
+	/// The text before the gap. With after_gap() that is all of it, and neither moves the gap.
+	std::string_view before_gap() const { return std::string_view(storage.data(), gap_begin); }
+
+	/// The text after the gap.
+	std::string_view after_gap() const { return std::string_view(storage.data() + gap_end, storage.size() - gap_end); }
+
+	/**
+	 * \brief The characters [pos, pos + count) as one view, without moving the gap.
+	 *
+	 * A range on one side of the gap is a view into the buffer. A range the gap splits is
+	 * copied into `scratch`, and the view points there. Either way it costs O(count) at
+	 * most, so readers that only need a part of the text should use this, not view().
+	 */
+	std::string_view slice(size_t pos, size_t count, std::string& scratch) const;
+
+	/// A copy of the text.
+	std::string str() const { return std::string(view()); }
+
+	/// Positions of every '\n' in the text, in order.
+	const std::vector<size_t>& line_breaks() const { return newlines; }
+
+	/// True if every character is ASCII, so byte offsets and columns are the same thing.
+	bool is_ascii() const { return non_ascii == 0; }
+
+	/// Changes on every edit, so callers can tell whether something they cached is stale.
+	std::uint64_t generation() const { return edit_generation; }
+
+private:
+	size_t gap_size() const { return gap_end - gap_begin; }
+	void move_gap(size_t pos) const;
+	void reserve_gap(size_t needed);
+
+	// The gap is only moved, never filled, by view(), which is why these are mutable.
+	mutable std::vector<char> storage;
+	mutable size_t gap_begin = 0;
+	mutable size_t gap_end = 0;
+
+	std::vector<size_t> newlines;
+	size_t non_ascii = 0; // bytes >= 0x80
+	std::uint64_t edit_generation = 0;
+};
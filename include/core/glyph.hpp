@@ -0,0 +1,74 @@
+/*****************************************************************//**
+ * \file   glyph.hpp
+ * \brief  Packs whatever gets drawn into a cell into a single 32 bit handle.
+ *
+ * Most cells hold a single code point, so that is stored inline. Anything longer
+ * (combining marks, emoji sequences, stray bytes) is interned once in a table and
+ * the handle just points into it, with the top bit set to tell the two apart.
+ *
+ * A wide character (CJK, most emoji) is stored in its first cell, and the cell to its
+ * right holds CONTINUATION so nothing else gets drawn over its second half.
+ *
+ * This keeps Cell trivially copyable, so clearing, copying and diffing the screen
+ * buffer is plain memory work instead of string juggling.
+ *
+ * \author parv141206
+ * \date   October 2026
+ *********************************************************************/
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+using Glyph = std::uint32_t;
+
+namespace glyph {
+
+	inline constexpr Glyph SPACE = ' ';
+
+	/// The right half of a wide glyph. It is never written out, the glyph to its left covers it.
+	inline constexpr Glyph CONTINUATION = 0;
+
+	/// Set on handles that index into the cluster table instead of holding a code point.
+	inline constexpr Glyph CLUSTER_BIT = 0x80000000u;
+
+	/**
+	 * \brief Slow path of from_utf8(), interns anything that is not a single code point.
+	 */
+	Glyph from_utf8_slow(std::string_view utf8);
+
+	/**
+	 * \brief Packs a UTF-8 encoded grapheme into a glyph handle.
+	 *
+	 * \param utf8 The bytes to draw in one cell. An empty string is treated as a space.
+	 * \return The code point itself, or an interned cluster handle.
+	 */
+	inline Glyph from_utf8(std::string_view utf8) {
+		if (utf8.size() == 1 && static_cast<unsigned char>(utf8[0]) < 0x80) {
+			return static_cast<unsigned char>(utf8[0]);
+		}
+		if (utf8.empty()) return SPACE;
+		return from_utf8_slow(utf8);
+	}
+
+	/**
+	 * \brief Slow path of width(), for wide ranges and interned clusters.
+	 */
+	int width_slow(Glyph g);
+
+	/**
+	 * \brief Number of cells a glyph covers: 2 for wide ones, 0 for CONTINUATION, 1 otherwise.
+	 */
+	inline int width(Glyph g) {
+		if (g < 0x1100) return g == CONTINUATION ? 0 : 1; // nothing below U+1100 is wide
+		return width_slow(g);
+	}
+
+	/**
+	 * \brief Appends the UTF-8 bytes of a glyph to the output string.
+	 *
+	 * \param out The string to append to.
+	 * \param g The glyph handle.
+	 */
+	void append_utf8(std::string& out, Glyph g);
+}
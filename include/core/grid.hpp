@@ -0,0 +1,152 @@
+/*****************************************************************//**
+ * \file   grid.hpp
+ * \brief  A Grid component that lays its children out in rows and columns.
+ *
+ * Flex only knows one axis, so tables used to be built from a Column of Rows, with every
+ * Row sizing its cells on its own and nothing lining up unless every cell was the same
+ * width. Grid sizes its columns once for all rows and its rows once for all columns, then
+ * places every child in its cell (or range of cells, for spans) in a single pass.
+ *
+ * Every track (row or column) is one of
+ * - fixed: a number of cells,
+ * - auto: as big as the largest child in it,
+ * - fraction: a share of the space the other two leave over, by weight.
+ *
+ * Track sizes are kept until the Grid's size or its layout generation changes, so a frame
+ * where nothing moved places the children without measuring anything.
+ *
+ * \author parv141206
+ * \date   October 2026
+ *********************************************************************/
+#pragma once
+#include "component.hpp"
+#include <memory>
+#include <vector>
+
+/// @brief How one row or column of a Grid is sized. Create these with fixed(), fraction() or auto_size().
+struct GridTrack {
+	enum class Kind {
+		Fixed,
+		Fraction,
+		Auto
+	};
+
+	Kind kind = Kind::Fraction;
+	int value = 1; ///< Cells for Fixed, weight for Fraction, unused for Auto.
+
+	/// A track that is always `cells` wide (or tall).
+	static GridTrack fixed(int cells) { return { Kind::Fixed, cells }; }
+
+	/// A track that takes `weight` shares of the space left after the fixed and auto tracks.
+	static GridTrack fraction(int weight = 1) { return { Kind::Fraction, weight }; }
+
+	/// A track as big as its largest child: preferred width for columns, height for rows.
+	static GridTrack auto_size() { return { Kind::Auto, 0 }; }
+};
+
+/**
+ * @brief A Grid component that arranges its children in cells of rows and columns.
+ *
+ * Example
+ * ```cpp
+ * // A label column sized to the longest label, and a value column taking the rest.
+ * auto grid = std::make_shared<Grid>(
+ *     std::vector<GridTrack>{ GridTrack::auto_size(), GridTrack::fraction() },
+ *     std::vector<GridTrack>{ GridTrack::fixed(1), GridTrack::fixed(1), GridTrack::fraction() }
+ * );
+ *
+ * grid->add(cpu_label, 0, 0).add(cpu_value, 0, 1);
+ * grid->add(mem_label, 1, 0).add(mem_value, 1, 1);
+ * grid->add(chart, 2, 0, 1, 2); // spans both columns
+ * grid->set_gap(0, 1);
+ * ```
+ */
+class Grid : public Component {
+	struct Placement {
+		std::shared_ptr<Component> child;
+		int row, column;
+		int row_span, column_span;
+	};
+
+	std::vector<GridTrack> columns;
+	std::vector<GridTrack> rows;
+	std::vector<Placement> cells;
+	int row_gap = 0;
+	int column_gap = 0;
+	int padding = 0;
+
+	// Track sizes and where each track starts, relative to the inner box. Columns depend on
+	// the width only, so a change of height keeps them and redoes just the rows.
+	std::vector<int> column_sizes, column_starts;
+	std::vector<int> row_sizes, row_starts;
+	int sized_width = -1;
+	int sized_height = -1;
+	std::uint64_t columns_generation = 0;
+	std::uint64_t rows_generation = 0;
+
+	// Scratch tracks for get_preferred_width/height, which must not touch the arrangement.
+	mutable std::vector<int> scratch_columns;
+	mutable std::vector<int> scratch_rows;
+
+	int size_tracks(bool horizontal, std::vector<int>& sizes, const std::vector<int>& widths, int available, bool fill) const;
+	int span_size(const std::vector<int>& sizes, int gap, int first, int span) const;
+	void arrange(int inner_w, int inner_h);
+
+public:
+	/**
+	 * \brief Creates an empty grid.
+	 * \param columns How each column is sized, left to right
+	 * \param rows How each row is sized, top to bottom
+	 */
+	Grid(std::vector<GridTrack> columns, std::vector<GridTrack> rows);
+
+	~Grid() override { release_children(); }
+
+	/**
+	 * \brief Puts a component in a cell. Cells outside the grid are not drawn, spans that
+	 * run past the last track are cut short.
+	 * \param child The component to add
+	 * \param row The row of its top-left cell
+	 * \param column The column of its top-left cell
+	 * \param row_span How many rows it covers
+	 * \param column_span How many columns it covers
+	 */
+	Grid& add(std::shared_ptr<Component> child, int row, int column, int row_span = 1, int column_span = 1);
+
+	/**
+	 * \brief Sets the space between tracks.
+	 * \param rows Empty lines between rows
+	 * \param columns Empty columns between columns
+	 */
+	Grid& set_gap(int rows, int columns);
+
+	/**
+	 * \brief Sets the padding around the cells.
+	 * \param p The padding to add
+	 */
+	Grid& set_padding(int p);
+
+	/// Removes all children. The tracks stay.
+	void clear();
+
+	/// Fixed and auto columns at their size, fraction columns at their widest child.
+	int get_preferred_width() const override;
+
+	/// Fixed and auto rows at their size, fraction rows at their tallest child.
+	int get_preferred_height(int width) const override;
+
+	// See core/component.hpp
+	bool caches_layout() const override { return true; }
+	size_t child_count() const override { return cells.size(); }
+	Component* child_at(size_t index) const override { return cells[index].child.get(); }
+	bool child_needs_layout(const Component& child) const override;
+
+	/**
+	 * \brief Renders the component at the specified position and size.
+	 * \param x The x-coordinate of the component's position.
+	 * \param y The y-coordinate of the component's position.
+	 * \param w The width of the component.
+	 * \param h The height of the component.
+	 */
+	void render(ScreenBuffer& buffer, int x, int y, int w, int h) override;
+};
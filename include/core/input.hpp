@@ -30,8 +30,11 @@ public:
 
 	Input(std::vector<std::shared_ptr<InputBox>>&& boxes)
 		: children(std::move(boxes)), gap(0), padding(0) {
+		adopt_children();
 	}
 
+	~Input() override { release_children(); }
+
 	/**
 	 * \brief Adds a single InputBox to the layout.
 	 * \param comp The InputBox to add
@@ -55,6 +58,14 @@ public:
 
 	int get_preferred_height(int width) const override;
 
+	// See core/component.hpp
+	bool caches_layout() const override { return true; }
+
+	// See core/component.hpp, boxes are laid out by their preferred height.
+	size_t child_count() const override { return children.size(); }
+	Component* child_at(size_t index) const override { return children[index].get(); }
+	bool child_needs_layout(const Component& child) const override;
+
 	/**
 	 * \brief Renders the component at the specified position and size.
 	 * \param x The x-coordinate of the component's position.
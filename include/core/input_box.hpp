@@ -8,7 +8,13 @@
 #pragma once
 
 #include "core/component.hpp"
+#include "core/gap_buffer.hpp"
+#include "core/unicode.hpp"
+#include <climits>
+#include <cstdint>
 #include <string>
+#include <string_view>
+#include <vector>
 #include <memory>
 
 /**
@@ -33,18 +39,81 @@
  */
 class InputBox : public Component {
 private:
-    std::string text;
+    GapBuffer text;
     bool active;
     bool wrap = false;
     int cursor = 0;
     std::string label;
 
+    int scroll_row = 0; // first wrapped row shown, moved by render() to keep the cursor visible
+
+    // Wrap layout: the first wrapped row of every logical line. Layout and render both need
+    // it, so it is only rebuilt after an edit or for a new width.
+    mutable std::vector<int> line_rows;
+    mutable int total_rows = 1;
+    mutable std::uint64_t layout_generation = ~std::uint64_t(0);
+    mutable int layout_width = -1;
+
+    // Without wrap: the cursor's column on screen, how far the line is scrolled and where the
+    // visible part starts (a byte offset and its column, -1 for a wide glyph cut by the left
+    // edge). Finding them walks the text up to the cursor, so they are kept until the text,
+    // the cursor or the width changes.
+    mutable int view_cursor_col = 0;
+    mutable int view_first_col = 0;
+    mutable size_t view_offset = 0;
+    mutable int view_offset_col = 0;
+    mutable std::uint64_t view_generation = ~std::uint64_t(0);
+    mutable int view_cursor = -1;
+    mutable int view_width = -1;
+
+    // Copies of text the gap splits, made by GapBuffer::slice(). Rows and single clusters
+    // each have their own, since a row is drawn after walking it cluster by cluster.
+    mutable std::string cluster_scratch;
+    mutable std::string row_scratch;
+
+    void update_layout(int innerW) const;
+    void update_view(int innerW) const;
+
+    // Where a walk over one line of wrapped text stopped: a byte offset and its row and
+    // column, counted from the start of the line.
+    struct WrapPos {
+        size_t offset;
+        int row;
+        int col;
+    };
+
+    // Wraps the line [begin, end) at `width` columns, stopping at byte `stop_offset` or at
+    // the start of row `stop_row`, whichever comes first.
+    WrapPos walk(size_t begin, size_t end, int width,
+                 size_t stop_offset = SIZE_MAX, int stop_row = INT_MAX) const;
+
+    // The cluster starting at `pos`, not reading past `end`. Reads the text on either side
+    // of the gap where it is, so the gap stays where the last edit left it.
+    unicode::Cluster cluster_at(size_t pos, size_t end) const {
+        const std::string_view before = text.before_gap();
+        if (pos >= before.size()) {
+            return unicode::next_cluster(text.after_gap().substr(0, end - before.size()), pos - before.size());
+        }
+        const unicode::Cluster c = unicode::next_cluster(before.substr(0, end), pos);
+        // Ending right at the gap, it may go on after it (the gap can even split a code point).
+        if (end <= before.size() || pos + c.length + 4 <= before.size()) return c;
+        return cluster_across_gap(pos, end);
+    }
+
+    // cluster_at() for a cluster that may run across the gap.
+    unicode::Cluster cluster_across_gap(size_t pos, size_t end) const;
+
+    // Start of the character before / after `pos`, so the cursor never lands inside one.
+    size_t previous_boundary(size_t pos) const;
+    size_t next_boundary(size_t pos) const;
+
 public:
 
     InputBox() : active(false) {}
 
     // See core/component.hpp 
     int get_preferred_height(int width) const;
+    bool caches_layout() const override { return true; }
 
     /**
      * @brief Sets the active state of the input box.
@@ -76,6 +145,11 @@ public:
      * @return The text content of the input box.
      */
     std::string get_text() const;
+    /**
+     * @brief A read-only view of the text, without copying it.
+     * @return The text content, valid until the input box is edited.
+     */
+    std::string_view text_view() const;
 
     /**
      * @brief Sets the text of the input box.
@@ -88,6 +162,12 @@ public:
      * @param ch The character input to process (DUDE PASS THIS CAREFULLY, SEE DOCS).
      */
     void handle_input(char ch);
+    /**
+     * @brief Inserts a whole string at the cursor in one go, like the text of a PASTE event.
+     * Only what handle_input() would have accepted is kept; tabs and line breaks become spaces.
+     * @param pasted The text to insert.
+     */
+    void insert_text(std::string_view pasted);
 
     /**
      * @brief Renders the input box at the specified position and size.
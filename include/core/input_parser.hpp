@@ -0,0 +1,110 @@
+/*****************************************************************//**
+ * \file   input_parser.hpp
+ * \brief  Turns the raw bytes coming from the terminal into InputEvents.
+ *
+ * Terminals send keys, mouse reports and replies to queries as one byte stream, and
+ * nothing stops a read() from ending in the middle of an escape sequence. The old parser
+ * looked at each read on its own, so a split sequence came out as a bare KEY_ESCAPE
+ * followed by garbage, which happens a lot with fast mouse motion.
+ *
+ * The parser is a small VT style state machine (ground, escape, CSI, SS3, bracketed
+ * paste) fed one byte at a time. Its state survives between reads, so a sequence can be
+ * split anywhere. Events are pushed into the caller's vector; the only memory the parser
+ * owns is the buffer collecting a paste, which keeps its capacity for the next one.
+ *
+ * \author parv141206
+ * \date   October 2026
+ *********************************************************************/
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "event.hpp"
+
+/**
+ * @brief Incremental parser for terminal input.
+ *
+ * Example:
+ * ```cpp
+ * InputParser parser;
+ * std::vector<InputEvent> events;
+ * parser.feed(bytes, n, events);
+ * if (parser.pending() && nothing_arrived_for_a_while) {
+ *     parser.flush(events); // a lone ESC was the Escape key after all
+ * }
+ * ```
+ */
+class InputParser {
+public:
+	/// Parses `size` bytes, appending every complete event to `events`.
+	void feed(const char* data, size_t size, std::vector<InputEvent>& events);
+
+	/// Parses a single byte.
+	void feed(char byte, std::vector<InputEvent>& events);
+
+	/**
+	 * \brief True while the parser is in the middle of an escape sequence.
+	 *
+	 * A lone ESC looks exactly like the start of a sequence, so the caller should give
+	 * the rest a moment to arrive and then call flush().
+	 */
+	bool pending() const { return state != State::GROUND && state != State::PASTE; }
+
+	/// True between the start and end markers of a bracketed paste.
+	bool in_paste() const { return state == State::PASTE; }
+
+	/**
+	 * \brief Gives up on the sequence in progress. A lone ESC becomes KEY_ESCAPE,
+	 * anything longer is dropped.
+	 */
+	void flush(std::vector<InputEvent>& events);
+
+	/**
+	 * \brief Merges mouse reports from one batch of input, starting at `first`.
+	 *
+	 * Runs of MOUSE_MOVE collapse into the last position, and runs of wheel events into a
+	 * single MOUSE_SCROLL_UP or MOUSE_SCROLL_DOWN carrying the net scroll_delta. Anything
+	 * else (keys, clicks) ends a run, so the order of events that matter is kept.
+	 */
+	static void coalesce(std::vector<InputEvent>& events, size_t first);
+
+	/**
+	 * \brief The last answer to the synchronized output (mode 2026) DECRQM query, -1 if none.
+	 * 1 or 2 means supported (set or reset), 0 or 4 means not.
+	 */
+	int synchronized_output_report() const { return sync_output_report; }
+
+private:
+	enum class State : std::uint8_t { GROUND, ESCAPE, CSI, SS3, PASTE };
+
+	static constexpr int MAX_PARAMS = 8;
+
+	void ground(unsigned char c, std::vector<InputEvent>& events);
+	void paste(unsigned char c, std::vector<InputEvent>& events);
+	void append_pasted(unsigned char c);
+	void start_csi();
+	void dispatch_csi(unsigned char final_byte, std::vector<InputEvent>& events);
+	void dispatch_mouse(bool release, std::vector<InputEvent>& events);
+
+	State state = State::GROUND;
+
+	// CSI sequence being collected.
+	int params[MAX_PARAMS] = {};
+	int param_count = 0;       // params seen so far, the last one may still be growing
+	unsigned char prefix = 0;  // private marker: '<', '=', '>' or '?', 0 if none
+	unsigned char intermediate = 0;
+
+	// Text of the bracketed paste in progress, and how many bytes of its end marker have matched.
+	std::string paste_text;
+	int paste_end_matched = 0;
+	bool paste_after_cr = false; // to turn "\r\n" into a single '\n'
+
+
+	// A click is a press followed by a release of the same button on the same cell.
+	int pressed_button = -1;
+	int pressed_x = -1;
+	int pressed_y = -1;
+
+	int sync_output_report = -1;
+};
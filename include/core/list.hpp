@@ -8,6 +8,7 @@
  *********************************************************************/
 #pragma once
 #include "component.hpp"
+#include "fenwick_tree.hpp"
 #include <vector>
 #include <memory>
 
@@ -34,16 +35,44 @@ class List : public Component {
     int scroll_offset = 0; 
     bool scrollbar_enabled = true; 
 
+    // Virtualized mode: every child's height (plus the gap after it) for one content width,
+    // so the first visible child is found in O(log n) instead of by walking the whole list.
+    bool virtualized = false;
+    mutable FenwickTree heights;
+    mutable int heights_width = -1; // -1 when the cache is not built for any width
+
+    // Otherwise: where each child starts, counted from the top of the content, followed by
+    // the total (last gap included). Kept until the width or the layout generation changes,
+    // so a frame where nothing changed measures nothing.
+    mutable std::vector<int> tops;
+    mutable int tops_width = -1;
+    mutable std::uint64_t tops_generation = 0;
+
+    // The children the last render drew, [drawn_first, drawn_end).
+    size_t drawn_first = 0;
+    size_t drawn_end = 0;
+
+    void build_heights(int content_w) const;
+    bool arrange(int content_w) const;
+    int content_width(int width) const;
+
+protected:
+    void refresh_children() override;
+
 public:
     template <typename... T>
     List(T&&... comps) : gap(0), padding(0) {
         add_components(std::forward<T>(comps)...);
+        adopt_children();
     }
 
     List(std::vector<std::shared_ptr<Component>>&& comps)
         : children(std::move(comps)), gap(0), padding(0) {
+        adopt_children();
     }
 
+    ~List() override { release_children(); }
+
     /**
      * \brief Adds a single component to the layout.
      * \param comp The component to add
@@ -81,11 +110,45 @@ public:
     List& set_scrollbar_enabled(bool enabled);
 
 
+    /**
+     * \brief Turns virtualized mode on or off.
+     *
+     * A virtualized list remembers the height of every child, finds the first visible one in
+     * O(log n) and only looks at the children on screen, which is what lists with hundreds of
+     * thousands of rows need. Children off screen are not refreshed or measured again until they
+     * scroll into view, or until invalidate_height(), so call that when an off-screen child
+     * changes its height.
+     * \param enabled Set to true to virtualize.
+     */
+    List& set_virtualized(bool enabled);
+
+    /**
+     * \brief Tells a virtualized list that the child at `index` may have changed its height.
+     * \param index The position of the child in the list.
+     */
+    void invalidate_height(size_t index);
+
+    /// Tells a virtualized list that any child may have changed its height.
+    void invalidate_heights();
+
+    /// Number of children.
+    size_t size() const { return children.size(); }
+
     /// Clears all children from the Input.
     void clear();
 
     int get_preferred_height(int width) const override;
 
+    // See core/component.hpp
+    bool caches_layout() const override { return true; }
+
+    // See core/component.hpp, children are laid out by their preferred height.
+    size_t child_count() const override { return children.size(); }
+    Component* child_at(size_t index) const override { return children[index].get(); }
+    std::pair<size_t, size_t> drawn_children() const override { return { drawn_first, drawn_end }; }
+    bool child_needs_layout(const Component& child) const override;
+    bool layout_moved() const override;
+
     /**
      * \brief Renders the component at the specified position and size.
      * \param x The x-coordinate of the component's position.
@@ -0,0 +1,119 @@
+/*****************************************************************//**
+ * \file   output_encoder.hpp
+ * \brief  Turns the difference between two frames into as few terminal bytes as possible.
+ *
+ * The runtime used to emit a full "\033[row;colH" before every changed cell and the
+ * whole style string whenever it changed. Over SSH every one of those bytes is latency,
+ * so the encoder instead:
+ *
+ * - writes runs of adjacent changed cells after a single cursor move,
+ * - picks the shortest way to get the cursor where it needs to be (nothing, CR/LF,
+ *   relative CUF/CUD, or an absolute CUP),
+ * - only emits the SGR parameters that actually differ between two styles,
+ * - builds everything in one reusable buffer, so a frame costs no allocations once
+ *   the buffer has grown to its working size.
+ *
+ * \author parv141206
+ * \date   October 2026
+ *********************************************************************/
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "screen_buffer.hpp"
+
+/**
+ * @brief Encodes frame diffs into terminal output.
+ *
+ * Example:
+ * ```cpp
+ * OutputEncoder encoder;
+ * encoder.begin_frame();
+ * encoder.encode_diff(frames.back(), frames.front());
+ * encoder.end_frame();
+ * write_somewhere(encoder.bytes());
+ * ```
+ */
+class OutputEncoder {
+public:
+	explicit OutputEncoder(size_t initial_capacity = 64 * 1024);
+
+	/**
+	 * \brief Starts a new frame. The byte buffer is emptied but keeps its capacity.
+	 *
+	 * The cursor position is forgotten between frames (the app may have printed something),
+	 * the current style is not, since every frame ends with the style back at reset.
+	 */
+	void begin_frame();
+
+	/**
+	 * \brief Wraps every following non-empty frame in ansi::BEGIN/END_SYNCHRONIZED_UPDATE,
+	 * so terminals that support it present the frame atomically. Takes effect at the next begin_frame().
+	 */
+	void set_synchronized(bool enabled) { synchronized = enabled; }
+
+	/**
+	 * \brief Appends raw bytes (like ansi::CLEAR_SCREEN) and forgets the cursor position.
+	 */
+	void append_raw(std::string_view bytes);
+
+	/**
+	 * \brief Appends everything needed to turn `previous` into `current` on the terminal.
+	 *
+	 * Both buffers must have the same size. Only rows inside either buffer's dirty spans are visited.
+	 */
+	void encode_diff(const ScreenBuffer& current, const ScreenBuffer& previous);
+
+	/**
+	 * \brief Finishes the frame, putting the style back to reset if anything was drawn.
+	 */
+	void end_frame();
+
+	/// The bytes of the current frame.
+	std::string_view bytes() const { return out; }
+
+	/// True if the current frame has nothing to write.
+	bool empty() const { return out.empty(); }
+
+private:
+	// Parsed form of an interned style, so two styles can be compared attribute by attribute.
+	struct SgrState {
+		enum : std::uint8_t { COLOR_DEFAULT, COLOR_BASIC, COLOR_256, COLOR_RGB };
+
+		struct Color {
+			std::uint8_t kind = COLOR_DEFAULT;
+			std::uint32_t value = 0; // the SGR code for COLOR_BASIC, the index or 0xRRGGBB otherwise
+
+			bool operator==(const Color& o) const { return kind == o.kind && value == o.value; }
+			bool operator!=(const Color& o) const { return !(*this == o); }
+		};
+
+		std::uint16_t flags = 0; // bit n set means "SGR n is on", for n in 1..9
+		Color fg, bg;
+		bool opaque = false;     // contains something other than SGR, has to be written verbatim
+	};
+
+	const SgrState& sgr_for(StyleId id);
+	static SgrState parse_sgr(std::string_view style);
+
+	void write_cell(const Cell& cell, int width, int screen_w);
+	void move_to(int x, int y);
+	void set_style(StyleId id);
+	void append_sgr_params(const SgrState& from, const SgrState& to);
+	void append_color(int base, const SgrState::Color& color);
+	void append_int(int value);
+	void append_param(int value);
+
+	std::string out;
+	std::vector<SgrState> sgr_cache;
+	std::vector<bool> sgr_cached;
+
+	int cursor_x = -1, cursor_y = -1; // -1 when unknown
+	StyleId style = StyleRegistry::RESET_ID;
+	bool style_known = false;         // false until the first style is written
+	bool first_param = true;
+
+	bool synchronized = false;
+	size_t frame_start = 0; // size of `out` right after begin_frame(), anything more is real output
+};
@@ -0,0 +1,83 @@
+/*****************************************************************//**
+ * \file   output_sink.hpp
+ * \brief  Writes frames straight to the terminal without blocking the UI.
+ *
+ * Frames used to go out through `std::cout << bytes << std::flush`, which pays for
+ * iostream locking and, on a slow pty or a congested SSH link, blocks the whole loop
+ * until the terminal has taken every byte.
+ *
+ * The sink writes with a plain write(2) on a non-blocking stdout. Whatever the terminal
+ * does not accept right away is kept and sent once stdout is writable again. While that
+ * happens the run loop does not encode new frames; it renders the latest state once the
+ * sink has drained, so frames the terminal could not keep up with are merged instead of
+ * piling up.
+ *
+ * \author parv141206
+ * \date   October 2026
+ *********************************************************************/
+#pragma once
+#include <string>
+#include <string_view>
+
+/**
+ * @brief Non-blocking writer for stdout.
+ *
+ * Example:
+ * ```cpp
+ * OutputSink sink;
+ * sink.write(encoder.bytes());
+ * if (sink.busy()) {
+ *     // wait until stdout is writable, then
+ *     sink.flush();
+ * }
+ * sink.close();
+ * ```
+ */
+class OutputSink {
+public:
+	/// Switches stdout to non-blocking mode.
+	OutputSink();
+
+	/// Calls close().
+	~OutputSink();
+
+	OutputSink(const OutputSink&) = delete;
+	OutputSink& operator=(const OutputSink&) = delete;
+
+	/**
+	 * \brief Writes as much of `bytes` as the terminal takes right now and keeps the rest.
+	 *
+	 * Anything still pending from earlier is sent first, so output always arrives in order.
+	 * \return True if everything was written.
+	 */
+	bool write(std::string_view bytes);
+
+	/**
+	 * \brief Tries to send the pending bytes again.
+	 * \return True if nothing is pending anymore.
+	 */
+	bool flush();
+
+	/// True while there are bytes the terminal has not accepted yet.
+	bool busy() const { return sent < pending.size(); }
+
+	/**
+	 * \brief Blocks until everything pending is written and restores stdout to how it was.
+	 * Call this before anything else writes to stdout. terminal::shutdown() does it for the
+	 * sink that is open at the time, so the Ctrl+C path restores stdout too.
+	 */
+	void close();
+
+	/// close() for the sink that owns stdout right now, if there is one.
+	static void close_active();
+
+private:
+	// Writes from `data` until done or the terminal would block, returns how much was written.
+	static size_t write_some(const char* data, size_t size);
+
+	std::string pending; // bytes not yet accepted by the terminal, starting at `sent`
+	size_t sent = 0;
+
+	int original_flags = -1; // stdout flags before we touched them, -1 if unknown
+	bool closed = false;
+};
@@ -35,6 +35,7 @@ private:
 	std::vector<std::shared_ptr<Radio>> radio_buttons;
 	int* target_index; 
 	int active_button_idx;
+	int drawn_target = -1; // *target_index as of the last render
     List internal_list; 
 
 public:
@@ -73,6 +74,14 @@ public:
 
 	int get_preferred_height(int width) const override;
 
+	// See core/component.hpp
+	bool caches_layout() const override { return true; }
+
+	// See core/component.hpp, the buttons are drawn through the internal list.
+	size_t child_count() const override { return 1; }
+	Component* child_at(size_t index) const override { return const_cast<List*>(&internal_list); }
+	bool poll() override;
+
     /**
 	 * @brief Renders the RadioGroup at the specified position and size.
 	 * @param x The x-coordinate of the input box's position.
@@ -44,34 +44,53 @@ struct RadioStyleBuilder {
 
 class Radio : public Component {
 private:
-	std::string label;
+	// Kept between frames: "(o) " or "( ) ", and the label next to it.
+	Text marker;
+	Text label_text;
 	bool is_selected;
 	bool is_active; 
 	RadioStyle style;
 
 public:
 	Radio(std::string label, const RadioStyle& style = RadioStyle())
-		: label(std::move(label)),
+		: marker("( ) "),
+		  label_text(std::move(label)),
 		  is_selected(false),
 		  is_active(false),
-		  style(style) {}
+		  style(style) {
+		adopt(&marker);
+		adopt(&label_text);
+	}
 
 	/**
 	 * @brief Sets the Radio active, as in, focused
 	 * 
 	 * @param active_state 
 	 */
-	void set_active(bool active_state) { is_active = active_state; }
+	void set_active(bool active_state) {
+		if (is_active != active_state) { is_active = active_state; mark_dirty(); }
+	}
 
 	/**
 	 * @brief Sets the Radio as currently selected
 	 * 
 	 * @param selected_state 
 	 */
-	void set_selected(bool selected_state) { is_selected = selected_state; }
+	void set_selected(bool selected_state) {
+		if (is_selected != selected_state) { is_selected = selected_state; mark_dirty(); }
+	}
 
 	int get_preferred_height(int width) const override;
 
+	// See core/component.hpp
+	bool caches_layout() const override { return true; }
+
+	int get_preferred_width() const override { return 4 + label_text.get_preferred_width(); }
+
+	// See core/component.hpp
+	size_t child_count() const override { return 2; }
+	Component* child_at(size_t index) const override { return const_cast<Text*>(index == 0 ? &marker : &label_text); }
+
 	/**
 	 * @brief Renders the Radio button at the specified position and size.
 	 * @param x The x-coordinate of the input box's position.
@@ -9,6 +9,7 @@
  *********************************************************************/
 #pragma once
 #include "screen.hpp"
+#include "frame_scheduler.hpp"
 #include <functional>
 #include <memory>
 #include "event.hpp"
@@ -24,16 +25,31 @@ namespace kontra {
 	 */
 	void shutdown();
 
+	/**
+	 * \brief Asks the run loop to draw a new frame.
+	 *
+	 * The loop sleeps until there is input or the terminal is resized, and redraws after those
+	 * on its own. Call this when the app state changes for any other reason (a timer, a worker
+	 * thread finishing, data arriving on a socket). Safe to call from any thread.
+	 */
+	void invalidate();
+
 	/**
 	 * \brief Runs the main event loop for the TUI application.
 	 *
-	 * This function will continuously poll for input and update the screen accordingly.
+	 * This function sleeps until there is input, a resize or an invalidate() call, and only
+	 * then renders a new frame and writes whatever changed to the terminal.
+	 * A burst of resizes (like dragging the window edge) is redrawn once, after the size
+	 * has stopped changing for a moment. When and how often frames are drawn is up to the
+	 * FrameScheduler.
 	 * It will call the provided onInput function whenever a character input is detected.
 	 *
 	 * \param screen The screen to be displayed and updated.
 	 * \param onInput A callback function that will be called with the input character when a key is pressed.
+	 * \param scheduler Frame pacing. The default draws on demand, at most once every 16ms.
 	 */
 	void run(std::shared_ptr<Screen> screen,
-		std::function<void(const InputEvent&)> onInput);
+		std::function<void(const InputEvent&)> onInput,
+		FrameScheduler scheduler = FrameScheduler());
 
 }
@@ -20,13 +20,49 @@
  */
 class Screen : public Component {
 	std::vector<std::shared_ptr<Component>> children;
+	bool retained = false;
 
 public:
 	template <typename... T>
 	Screen(T&&... comps) {
 		(children.emplace_back(std::forward<T>(comps)), ...);
+		adopt_children();
 	}
 
+	~Screen() override { release_children(); }
+
+	/**
+	 * @brief Turns retained mode on or off. Off by default.
+	 *
+	 * Normally every frame renders the whole tree into a blank buffer. In retained mode the
+	 * runtime keeps the last frame around and calls update() instead, which only renders the
+	 * components that called mark_dirty() (or whose poll() saw a change) since then. A mostly
+	 * static screen with one ticking counter then costs one Text render per frame.
+	 *
+	 * Components that read state through a pointer or a callback and do not poll it need a
+	 * mark_dirty() call when that state changes, or they keep showing the old value.
+	 */
+	Screen& set_retained(bool enabled);
+
+	bool is_retained() const { return retained; }
+
+	/**
+	 * @brief Brings `canvas` up to date, drawing only what changed since the last call.
+	 *
+	 * The first call, and any call after the canvas changed size, renders everything. `canvas`
+	 * has to be the same buffer every time, and nothing else may draw into it.
+	 *
+	 * @return False if nothing changed, so the last frame can stay on the terminal as it is.
+	 */
+	bool update(ScreenBuffer& canvas);
+
+	// See core/component.hpp
+	bool caches_layout() const override { return true; }
+	size_t child_count() const override { return children.size(); }
+	Component* child_at(size_t index) const override { return children[index].get(); }
+	// Every child covers the whole screen, so when there are several they overlap.
+	bool child_needs_layout(const Component& child) const override { return children.size() > 1; }
+
 	/**
 	 * @brief Renders the input box at the specified position and size.
 	 * @param x The x-coordinate of the input box's position.
@@ -16,22 +16,85 @@
 #pragma once
 #include <vector>
 #include <string>
+#include <algorithm>
+#include <string_view>
+#include <type_traits>
 #include "ansi.hpp" 
+#include "glyph.hpp"
+#include "style_registry.hpp"
 
- // Represents a single cell on the terminal screen
+ // Represents a single cell on the terminal screen.
+ // Both fields are plain integers, so a whole grid of these can be filled, copied and compared like raw memory.
 struct Cell {
-	std::string character = " ";
-	std::string style = ansi::RESET;
+	Glyph glyph = glyph::SPACE;
+	StyleId style = StyleRegistry::RESET_ID;
+
+	bool operator==(const Cell& other) const {
+		return glyph == other.glyph && style == other.style;
+	}
 
 	bool operator!=(const Cell& other) const {
-		return character != other.character || style != other.style;
+		return !(*this == other);
 	}
 };
 
-// Represents the entire terminal grid in memory
+static_assert(std::is_trivially_copyable_v<Cell> && sizeof(Cell) == 8, "Cell must stay a packed POD");
+
+/**
+ * @brief A run of cells inside one row of a ScreenBuffer. Basically std::span, which we dont have on C++17.
+ *
+ * Spans handed out by ScreenBuffer::span() are already clipped to the buffer, so writing through them
+ * needs no further bounds checks. `clipped_left` says how many of the requested cells fell off the left
+ * edge, so index `i` of the span is column `i + clipped_left` of what was asked for.
+ */
+template <typename T>
+struct BasicCellSpan {
+	T* data = nullptr;
+	int size = 0;
+	int clipped_left = 0;
+
+	T* begin() const { return data; }
+	T* end() const { return data + size; }
+	T& operator[](int i) const { return data[i]; }
+	bool empty() const { return size == 0; }
+
+	/// Sets every cell of the span to the same value.
+	void fill(const Cell& cell) const { std::fill(begin(), end(), cell); }
+};
+
+using CellSpan = BasicCellSpan<Cell>;
+using ConstCellSpan = BasicCellSpan<const Cell>;
+
+/// The columns [begin, end) of one row that were written since the buffer was last cleared.
+struct DirtySpan {
+	int begin = 0;
+	int end = 0;
+
+	bool empty() const { return begin >= end; }
+
+	/// Smallest span covering both, an empty side is ignored.
+	DirtySpan merged(const DirtySpan& other) const {
+		if (empty()) return other;
+		if (other.empty()) return *this;
+		return { std::min(begin, other.begin), std::max(end, other.end) };
+	}
+};
+
+/// Rows [top, bottom) of a ScreenBuffer that writes are limited to.
+struct RowClip {
+	int top = 0;
+	int bottom = 0;
+};
+
+// Represents the entire terminal grid in memory, as one contiguous row-major array.
+//
+// Every write also records which columns of which rows were touched since the last clear().
+// Anything outside those dirty spans is guaranteed to be blank, which lets clear() and the
+// frame diff skip rows nobody drew on.
 class ScreenBuffer {
 public:
-	ScreenBuffer(int width, int height) : w(width), h(height), buffer(height, std::vector<Cell>(width)) {}
+	ScreenBuffer(int width, int height)
+		: w(width), h(height), cells(static_cast<size_t>(width) * height), dirty(height), clip{ 0, height } {}
 
 	/**
 	 * \brief Resizes the screen buffer to the new width and height.
@@ -42,16 +105,27 @@ public:
 	void resize(int new_w, int new_h) {
 		w = new_w;
 		h = new_h;
-		buffer.assign(h, std::vector<Cell>(w));
+		cells.assign(static_cast<size_t>(w) * h, Cell());
+		dirty.assign(h, DirtySpan());
+		dirty_top = h;
+		dirty_bottom = 0;
+		clip = { 0, h };
 	}
 
 	/**
 	 * \brief Clears the screen buffer by resetting all cells to their default state.
+	 *
+	 * Only the dirty spans are touched, everything else is blank already.
 	 */
 	void clear() {
-		for (auto& row : buffer) {
-			std::fill(row.begin(), row.end(), Cell());
+		for (int y = dirty_top; y < dirty_bottom; ++y) {
+			DirtySpan& span = dirty[y];
+			if (span.empty()) continue;
+			std::fill_n(cells.data() + index(span.begin, y), span.end - span.begin, Cell());
+			span = DirtySpan();
 		}
+		dirty_top = h;
+		dirty_bottom = 0;
 	}
 
 	/**
@@ -62,9 +136,27 @@ public:
 	 * \param ch The character to set in the cell.
 	 * \param style The style (e.g., color or formatting) to apply to the cell.
 	 */
-	void set_cell(int x, int y, const std::string& ch, const std::string& style) {
-		if (x >= 0 && x < w && y >= 0 && y < h) {
-			buffer[y][x] = { ch, style };
+	void set_cell(int x, int y, std::string_view ch, std::string_view style) {
+		if (x >= 0 && x < w && y >= clip.top && y < clip.bottom) {
+			cells[index(x, y)] = { glyph::from_utf8(ch), StyleRegistry::intern(style) };
+			mark_dirty(x, x + 1, y, y + 1);
+		}
+	}
+
+	/**
+	 * \brief Sets a cell from an already packed glyph and interned style.
+	 *
+	 * Prefer this in render loops: intern the style once, then write as many cells as needed.
+	 *
+	 * \param x The x-coordinate of the cell (column index).
+	 * \param y The y-coordinate of the cell (row index).
+	 * \param g The glyph to set in the cell.
+	 * \param style The interned style id.
+	 */
+	void set_cell(int x, int y, Glyph g, StyleId style) {
+		if (x >= 0 && x < w && y >= clip.top && y < clip.bottom) {
+			cells[index(x, y)] = { g, style };
+			mark_dirty(x, x + 1, y, y + 1);
 		}
 	}
 
@@ -76,13 +168,209 @@ public:
 	 * \return A constant reference to the `Cell` at the specified coordinates.
 	 */
 	const Cell& get_cell(int x, int y) const {
-		return buffer[y][x];
+		return cells[index(x, y)];
+	}
+
+	/**
+	 * \brief Returns a whole row of the buffer for writing. `y` must be inside the buffer.
+	 */
+	CellSpan row(int y) {
+		mark_dirty(0, w, y, y + 1);
+		return { cells.data() + index(0, y), w, 0 };
+	}
+
+	ConstCellSpan row(int y) const {
+		return { cells.data() + index(0, y), w, 0 };
+	}
+
+	/**
+	 * \brief Returns `count` cells of row `y` starting at column `x`, clipped to the buffer
+	 * and to the row clip.
+	 *
+	 * The span is empty if the run lies completely outside the buffer. The returned cells count as
+	 * dirty, so only ask for what is actually going to be written.
+	 *
+	 * \param x The first column of the run, may be negative.
+	 * \param y The row of the run, may be outside the buffer.
+	 * \param count The number of cells asked for.
+	 */
+	CellSpan span(int x, int y, int count) {
+		if (y < clip.top || y >= clip.bottom) return {};
+		int start = std::max(x, 0);
+		int end = std::min(x + count, w);
+		if (start >= end) return {};
+		mark_dirty(start, end, y, y + 1);
+		return { cells.data() + index(start, y), end - start, start - x };
+	}
+
+	/**
+	 * \brief Fills a rectangle with one cell value, clipped to the buffer and to the row clip.
+	 *
+	 * \param x The left column of the rectangle.
+	 * \param y The top row of the rectangle.
+	 * \param rect_w The width of the rectangle.
+	 * \param rect_h The height of the rectangle.
+	 * \param cell The cell to fill with.
+	 */
+	void fill_rect(int x, int y, int rect_w, int rect_h, const Cell& cell) {
+		int x0 = std::max(x, 0), x1 = std::min(x + rect_w, w);
+		int y0 = std::max(y, clip.top), y1 = std::min(y + rect_h, clip.bottom);
+		if (x0 >= x1 || y0 >= y1) return;
+		mark_dirty(x0, x1, y0, y1);
+		for (int row_y = y0; row_y < y1; ++row_y) {
+			std::fill_n(cells.data() + index(x0, row_y), x1 - x0, cell);
+		}
 	}
 
+	/**
+	 * \brief Copies a rectangle from another buffer into this one. Both sides are clipped.
+	 *
+	 * \param src The buffer to copy from. Must not be this buffer.
+	 * \param src_x The left column of the source rectangle.
+	 * \param src_y The top row of the source rectangle.
+	 * \param rect_w The width of the rectangle.
+	 * \param rect_h The height of the rectangle.
+	 * \param dst_x The left column to copy to.
+	 * \param dst_y The top row to copy to.
+	 */
+	void copy_rect(const ScreenBuffer& src, int src_x, int src_y, int rect_w, int rect_h, int dst_x, int dst_y) {
+		// Clip against the source first, then shift the same amount on the destination side.
+		if (src_x < 0) { rect_w += src_x; dst_x -= src_x; src_x = 0; }
+		if (src_y < 0) { rect_h += src_y; dst_y -= src_y; src_y = 0; }
+		if (dst_x < 0) { rect_w += dst_x; src_x -= dst_x; dst_x = 0; }
+		if (dst_y < 0) { rect_h += dst_y; src_y -= dst_y; dst_y = 0; }
+		rect_w = std::min({ rect_w, src.w - src_x, w - dst_x });
+		rect_h = std::min({ rect_h, src.h - src_y, h - dst_y });
+		if (rect_w <= 0 || rect_h <= 0) return;
+
+		mark_dirty(dst_x, dst_x + rect_w, dst_y, dst_y + rect_h);
+		for (int i = 0; i < rect_h; ++i) {
+			const Cell* from = src.cells.data() + src.index(src_x, src_y + i);
+			std::copy_n(from, rect_w, cells.data() + index(dst_x, dst_y + i));
+		}
+	}
+
+	/**
+	 * \brief Copies the whole of another buffer into this one with its top-left corner at (x, y).
+	 */
+	void blit(const ScreenBuffer& src, int x, int y) {
+		copy_rect(src, 0, 0, src.w, src.h, x, y);
+	}
+
+	/**
+	 * \brief Copies everything `src` drew into this buffer, which must be blank and the same size.
+	 *
+	 * Only the dirty spans of `src` are copied, and they become the dirty spans here, so the
+	 * frame diff still skips whatever neither frame drew on.
+	 */
+	void copy_drawn(const ScreenBuffer& src) {
+		for (int y = src.dirty_top; y < src.dirty_bottom; ++y) {
+			const DirtySpan& span = src.dirty[y];
+			if (span.empty()) continue;
+			std::copy_n(src.cells.data() + src.index(span.begin, y), span.end - span.begin, cells.data() + index(span.begin, y));
+			mark_dirty(span.begin, span.end, y, y + 1);
+		}
+	}
+
+	/**
+	 * \brief Returns the columns of row `y` written since the last clear(). `y` must be inside the buffer.
+	 */
+	DirtySpan dirty_span(int y) const { return dirty[y]; }
+
+	/// First row with a dirty span, or height() if nothing was drawn.
+	int dirty_rows_begin() const { return dirty_top; }
+
+	/// One past the last row with a dirty span.
+	int dirty_rows_end() const { return dirty_bottom; }
+
 	int width() const { return w; }
 	int height() const { return h; }
 
+	/**
+	 * \brief Limits set_cell(), span() and fill_rect() to rows [top, bottom), inside the limit
+	 * already in place, and returns that limit for restore_clip().
+	 *
+	 * Containers that scroll set it around their children, so a child that is only partly in
+	 * view cannot draw over whatever is above or below the container.
+	 */
+	RowClip clip_rows(int top, int bottom) {
+		RowClip previous = clip;
+		clip.top = std::max(top, previous.top);
+		clip.bottom = std::max(clip.top, std::min(bottom, previous.bottom));
+		return previous;
+	}
+
+	/// Puts back a limit returned by clip_rows().
+	void restore_clip(RowClip previous) { clip = previous; }
+
+	/// The rows writes are limited to right now, the whole buffer unless clip_rows() narrowed it.
+	RowClip row_clip() const { return clip; }
+
 private:
+	size_t index(int x, int y) const {
+		return static_cast<size_t>(y) * w + x;
+	}
+
+	// Arguments must already be clipped to the buffer.
+	void mark_dirty(int x0, int x1, int y0, int y1) {
+		for (int y = y0; y < y1; ++y) {
+			DirtySpan& span = dirty[y];
+			if (span.empty()) {
+				span = { x0, x1 };
+			}
+			else {
+				span.begin = std::min(span.begin, x0);
+				span.end = std::max(span.end, x1);
+			}
+		}
+		dirty_top = std::min(dirty_top, y0);
+		dirty_bottom = std::max(dirty_bottom, y1);
+	}
+
 	int w, h;
-	std::vector<std::vector<Cell>> buffer;
-};
\ No newline at end of file
+	std::vector<Cell> cells;
+	std::vector<DirtySpan> dirty;
+	int dirty_top = h;
+	int dirty_bottom = 0;
+	RowClip clip;
+};
+
+/**
+ * @brief The pair of buffers the runtime draws with: the front one is what the terminal currently shows,
+ * the back one is where the next frame gets rendered.
+ *
+ * Presenting a frame just flips which one is which, so no cells are ever copied between them.
+ */
+class DoubleBuffer {
+public:
+	DoubleBuffer(int width, int height) : buffers{ ScreenBuffer(width, height), ScreenBuffer(width, height) } {}
+
+	/// The buffer that matches what is on the terminal right now.
+	const ScreenBuffer& front() const { return buffers[front_index]; }
+
+	/// The buffer the next frame is rendered into.
+	ScreenBuffer& back() { return buffers[front_index ^ 1]; }
+
+	/**
+	 * \brief Makes the back buffer the new front buffer in O(1), and blanks the old front for the next frame.
+	 */
+	void present() {
+		front_index ^= 1;
+		back().clear();
+	}
+
+	/**
+	 * \brief Resizes both buffers. Both end up blank, so the caller should clear the terminal too.
+	 */
+	void resize(int new_w, int new_h) {
+		buffers[0].resize(new_w, new_h);
+		buffers[1].resize(new_w, new_h);
+	}
+
+	int width() const { return front().width(); }
+	int height() const { return front().height(); }
+
+private:
+	ScreenBuffer buffers[2];
+	int front_index = 0;
+};
@@ -0,0 +1,47 @@
+/*****************************************************************//**
+ * \file   style_registry.hpp
+ * \brief  Interns ANSI style strings so cells only have to carry a small id.
+ *
+ * Every distinct style string (like FG_CYAN + BG_DEFAULT + BOLD) is stored exactly
+ * once for the lifetime of the program. Cells, the frame diff and the output code
+ * all work with the id, and only look the string up again when writing it out.
+ *
+ * \author parv141206
+ * \date   October 2026
+ *********************************************************************/
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+using StyleId = std::uint32_t;
+
+/**
+ * @brief Process wide table of interned ANSI style strings.
+ *
+ * Example:
+ * ```cpp
+ * StyleId id = StyleRegistry::intern(std::string(ansi::FG_RED) + ansi::BOLD);
+ * buffer.set_cell(0, 0, 'x', id);
+ * ```
+ */
+class StyleRegistry {
+public:
+	/// Id of ansi::RESET, which is what blank cells use.
+	static constexpr StyleId RESET_ID = 0;
+
+	/**
+	 * \brief Returns the id of a style string, registering it the first time it is seen.
+	 * \param style The raw ANSI escape sequence(s) making up the style.
+	 */
+	static StyleId intern(std::string_view style);
+
+	/**
+	 * \brief Returns the ANSI string an id was interned from.
+	 * \param id An id previously returned by intern().
+	 */
+	static const std::string& get(StyleId id);
+
+	/// Number of distinct styles interned so far.
+	static std::size_t size();
+};
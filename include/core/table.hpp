@@ -0,0 +1,296 @@
+/*****************************************************************//**
+ * \file   table.hpp
+ * \brief  A scrolling table that only reads the cells that are on screen.
+ *
+ * Tables used to be a Column of Rows with a Text per cell, so a thousand rows of ten
+ * columns meant ten thousand components, each measured and drawn every frame. Table has
+ * no components at all: it asks a data source for the text of the visible cells and draws
+ * them straight into the buffer. Work per frame and memory both depend on the size of the
+ * viewport, not on the number of rows.
+ *
+ * The header stays at the top while the rows scroll underneath it. Scrolling sideways
+ * moves a whole column at a time.
+ *
+ * Auto sized columns are as wide as the widest cell seen so far. Each column remembers
+ * which rows it has already measured, so a frame only measures rows that just came
+ * into view, and only in the columns that are visible.
+ *
+ * \author parv141206
+ * \date   October 2026
+ *********************************************************************/
+#pragma once
+#include "component.hpp"
+#include "text.hpp"
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Where a Table gets its cells from.
+ *
+ * cell() is called for every visible cell on every frame it is drawn, so it should be a
+ * lookup, not a computation.
+ */
+class TableSource {
+public:
+	virtual ~TableSource() = default;
+
+	/// Number of rows in the data.
+	virtual size_t row_count() const = 0;
+
+	/// Text of one cell. The view only has to stay valid until the next call.
+	virtual std::string_view cell(size_t row, size_t column) const = 0;
+
+	/**
+	 * @brief Changes whenever rows that already exist are edited or removed, so the Table
+	 * knows to redraw and to measure its columns again. Appending rows does not need it.
+	 */
+	virtual std::uint64_t generation() const { return 0; }
+};
+
+/**
+ * @brief A TableSource that keeps every column in one block of memory.
+ *
+ * A cell costs its bytes plus one offset, instead of a std::string (and usually a heap
+ * allocation) each, so a million rows stay a handful of large allocations.
+ *
+ * Example
+ * ```cpp
+ * auto data = std::make_shared<ColumnarTableSource>(3);
+ * data->append_row({ "1", "init", "0.0" });
+ * data->append_row({ "42", "server", "12.5" });
+ * ```
+ */
+class ColumnarTableSource : public TableSource {
+	struct Column {
+		std::string bytes;
+		std::vector<size_t> ends; // ends[i] is one past the last byte of row i
+	};
+	std::vector<Column> columns;
+	size_t rows = 0;
+	std::uint64_t edit_generation = 0;
+
+public:
+	/// An empty source with `columns` columns.
+	explicit ColumnarTableSource(size_t columns);
+
+	/// Adds a row. Missing cells are empty, extra ones are ignored.
+	void append_row(std::initializer_list<std::string_view> cells);
+
+	/// Adds a row. Missing cells are empty, extra ones are ignored.
+	void append_row(const std::vector<std::string>& cells);
+
+	/**
+	 * @brief Reserves room for `rows` rows averaging `cell_bytes` bytes per cell, so
+	 * loading a big result does not keep growing the columns.
+	 */
+	void reserve(size_t rows, size_t cell_bytes = 8);
+
+	/// Removes all rows.
+	void clear();
+
+	size_t row_count() const override { return rows; }
+	std::string_view cell(size_t row, size_t column) const override;
+	std::uint64_t generation() const override { return edit_generation; }
+};
+
+enum class ColumnAlignment { Left, Center, Right };
+
+/// @brief One column of a Table. Create this with a TableColumnBuilder.
+struct TableColumn {
+	/// A width of AUTO means as wide as the title and the widest cell seen so far, within min and max.
+	static constexpr int AUTO = -1;
+
+	std::string title;
+	int width = AUTO;
+	int min_width = 1;
+	int max_width = INT_MAX;
+	ColumnAlignment alignment = ColumnAlignment::Left;
+};
+
+/**
+ * @brief Fluent builder for TableColumn.
+ *
+ * Example
+ * ```cpp
+ * auto pid = TableColumnBuilder().set_title("PID").set_width(7).set_alignment(ColumnAlignment::Right).build();
+ * auto name = TableColumnBuilder().set_title("Name").set_max_width(30).build();
+ * ```
+ */
+struct TableColumnBuilder {
+	TableColumn column;
+	TableColumnBuilder& set_title(const std::string& title) { column.title = title; return *this; }
+	TableColumnBuilder& set_width(int width) { column.width = width; return *this; }
+	TableColumnBuilder& set_min_width(int width) { column.min_width = width; return *this; }
+	TableColumnBuilder& set_max_width(int width) { column.max_width = width; return *this; }
+	TableColumnBuilder& set_alignment(ColumnAlignment alignment) { column.alignment = alignment; return *this; }
+	TableColumn build() const { return column; }
+};
+
+struct TableStyle {
+	TextStyle header_style = TextStyle("", ansi::BG_DEFAULT, true);
+	TextStyle cell_style;
+	TextStyle stripe_style; ///< Used for every other row when `striped` is set.
+	bool striped = false;
+	int column_gap = 1;
+};
+
+/**
+ * @brief Fluent builder for TableStyle.
+ *
+ * Example
+ * ```cpp
+ * auto style = TableStyleBuilder()
+ *     .set_header_style(StyleBuilder().set_color(ansi::FG_CYAN).set_bold(true).build())
+ *     .set_stripe_style(StyleBuilder().set_background_color(ansi::BG_BRIGHT_BLACK).build())
+ *     .set_column_gap(2)
+ *     .build();
+ * ```
+ */
+struct TableStyleBuilder {
+	TableStyle style;
+	TableStyleBuilder& set_header_style(const TextStyle& s) { style.header_style = s; return *this; }
+	TableStyleBuilder& set_cell_style(const TextStyle& s) { style.cell_style = s; return *this; }
+	TableStyleBuilder& set_stripe_style(const TextStyle& s) { style.stripe_style = s; style.striped = true; return *this; }
+	TableStyleBuilder& set_column_gap(int gap) { style.column_gap = gap; return *this; }
+	TableStyle build() const { return style; }
+};
+
+/**
+ * @brief A table of one line rows with a header that stays put.
+ *
+ * Example
+ * ```cpp
+ * auto table = std::make_shared<Table>(
+ *     std::vector<TableColumn>{ pid, name, cpu },
+ *     data // a ColumnarTableSource, or any TableSource
+ * );
+ *
+ * table->scroll_down(10);
+ * table->scroll_right();
+ * ```
+ */
+class Table : public Component {
+	std::shared_ptr<TableSource> source;
+	std::vector<TableColumn> columns;
+	TableStyle style;
+	bool scrollbar_enabled = true;
+
+	size_t scroll_row = 0;      // first row under the header
+	size_t first_column = 0;    // leftmost column on screen
+	size_t reveal_row = SIZE_MAX; // row to scroll into view on the next render
+
+	// Per column: the widest cell measured so far and the width that makes for. Rows
+	// [measured_begin, measured_end) are the run measured last, so scrolling within or next
+	// to it only measures the rows that are new. Thrown away when the source's generation changes.
+	struct ColumnCache {
+		int content = 0;
+		int width = 0;
+		size_t measured_begin = 0, measured_end = 0;
+	};
+	std::vector<ColumnCache> widths;
+	std::uint64_t widths_generation = 0;
+
+	StyleId header_id = 0, header_bg_id = 0;
+	StyleId cell_id = 0, cell_bg_id = 0;
+	StyleId stripe_id = 0, stripe_bg_id = 0;
+	bool styles_interned = false;
+
+	// Where the rows went in the last frame, for row_at().
+	size_t first_drawn = 0;
+	int first_drawn_y = 0;
+	size_t drawn_count = 0;
+	size_t drawn_rows = 0; // row_count() as of the last render
+	std::uint64_t drawn_generation = 0;
+
+	int column_width(size_t column, size_t first_row, size_t end_row);
+	void intern_styles();
+
+public:
+	/**
+	 * @brief A table backed by a data source.
+	 * @param columns The columns, left to right.
+	 * @param source Provides the rows.
+	 */
+	Table(std::vector<TableColumn> columns, std::shared_ptr<TableSource> source);
+
+	/**
+	 * @brief A table backed by two functions.
+	 * @param columns The columns, left to right.
+	 * @param row_count Returns the number of rows.
+	 * @param cell Returns the text of a cell.
+	 */
+	Table(std::vector<TableColumn> columns, std::function<size_t()> row_count, std::function<std::string(size_t row, size_t column)> cell);
+
+	/**
+	 * @brief Sets the header, cell and stripe styles and the space between columns.
+	 * @param s The style to use.
+	 */
+	Table& set_style(const TableStyle& s);
+
+	/**
+	 * @brief Enables or disables the scrollbar shown when the rows do not fit.
+	 * @param enabled Set to true to show the scrollbar.
+	 */
+	Table& set_scrollbar_enabled(bool enabled);
+
+	/// Scrolls up by a number of rows.
+	void scroll_up(size_t amount = 1);
+
+	/// Scrolls down by a number of rows.
+	void scroll_down(size_t amount = 1);
+
+	/// Scrolls left by a number of columns.
+	void scroll_left(size_t amount = 1);
+
+	/// Scrolls right by a number of columns.
+	void scroll_right(size_t amount = 1);
+
+	/**
+	 * @brief Scrolls just enough to show row `index` on the next render.
+	 * @param index The row to show.
+	 */
+	void scroll_to_row(size_t index);
+
+	/// First row under the header.
+	size_t get_scroll_row() const { return scroll_row; }
+
+	/// Leftmost column on screen.
+	size_t get_first_column() const { return first_column; }
+
+	/**
+	 * @brief Finds the row under the mouse, using the positions from the last render.
+	 * @return The row index, or -1 if the point is on the header or not on a row.
+	 */
+	long long row_at(int mouse_x, int mouse_y) const;
+
+	/// The header plus one line per row.
+	int get_preferred_height(int width) const override;
+
+	// See core/component.hpp
+	bool caches_layout() const override { return true; }
+
+	/// Every column at the width it has now, gaps included.
+	int get_preferred_width() const override;
+
+	/**
+	 * @brief Notices rows being added, removed or edited, through the row count and the
+	 * source's generation().
+	 */
+	bool poll() override;
+
+	/**
+	 * @brief Renders the header and the rows that are on screen.
+	 * @param x The x-coordinate of the table's position.
+	 * @param y The y-coordinate of the table's position.
+	 * @param w The width of the table.
+	 * @param h The height of the table.
+	 */
+	void render(ScreenBuffer& buffer, int x, int y, int w, int h) override;
+};
@@ -22,10 +22,19 @@ private:
 
 public:
     Tab(std::shared_ptr<Component> child_component, const std::string& label_text = "")
-        : child(child_component), label(label_text) {}
+        : child(child_component), label(label_text) {
+        adopt(child.get());
+    }
+
+    ~Tab() override { release_children(); }
 
     const std::string& get_label() const { return label; }
 
+    // See core/component.hpp
+    bool caches_layout() const override { return true; }
+    size_t child_count() const override { return child ? 1 : 0; }
+    Component* child_at(size_t index) const override { return child.get(); }
+
     void render(ScreenBuffer& buffer, int x, int y, int w, int h) override;
 };
 
@@ -112,7 +121,11 @@ private:
 
 public:
     Tabs(std::vector<std::shared_ptr<Tab>> tab_components, TabsStyle style = TabsStyle())
-        : tabs(std::move(tab_components)), current_tab_idx(0), style(style) {}
+        : tabs(std::move(tab_components)), current_tab_idx(0), style(style) {
+        adopt_children();
+    }
+
+    ~Tabs() override { release_children(); }
 
     /**
      * @brief Changes the current tab to specified tab.
@@ -136,5 +149,11 @@ public:
      */
     void handle_mouse_input(int mouse_x, int mouse_y);
 
+    // See core/component.hpp, only the current tab is ever drawn.
+    bool caches_layout() const override { return true; }
+    size_t child_count() const override { return tabs.size(); }
+    Component* child_at(size_t index) const override { return tabs[index].get(); }
+    Cell backdrop() const override;
+
     void render(ScreenBuffer& buffer, int x, int y, int w, int h) override;
 };
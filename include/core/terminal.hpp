@@ -8,10 +8,36 @@
 #pragma once
 
 #include "event.hpp"
+#include <utility>
 #include <vector>
 
 namespace kontra::terminal {
 
+    /**
+     * \brief Which mouse reports the terminal should send.
+     */
+    enum class MouseTracking {
+        ALL_MOTION, ///< Clicks, wheel and every movement, even without a button held (mode 1003). Needed for hover.
+        BUTTONS,    ///< Clicks, wheel and movement only while a button is held (mode 1002).
+    };
+
+    /**
+     * \brief Picks the mouse tracking mode. Call it before initialize() (or kontra::run()).
+     *
+     * The default is ALL_MOTION. Apps that never look at MOUSE_MOVE without a button held
+     * should use BUTTONS, so moving the mouse around does not wake them up at all.
+     */
+    void set_mouse_tracking(MouseTracking mode);
+
+    /**
+     * \brief Turns bracketed paste on or off. Call it before initialize() (or kontra::run()).
+     *
+     * Off by default, so pasted text arrives as one KEY_PRESS per byte, like typing. Turned on,
+     * every paste arrives as a single PASTE event with the whole text, which the app then has
+     * to handle (InputBox::insert_text() takes it directly).
+     */
+    void set_bracketed_paste(bool enabled);
+
     /**
      * \brief Initializes the terminal for TUI use.
      * Sets up raw/virtual terminal mode, enables mouse input, and hides the cursor.
@@ -21,7 +47,8 @@ namespace kontra::terminal {
 
     /**
      * \brief Resets the terminal to its original state.
-     * Disables mouse input, shows the cursor, and restores original console modes.
+     * Sends any output still queued by an OutputSink and makes stdout blocking again, then
+     * disables mouse input, shows the cursor, and restores original console modes.
      * This must be called when the application exits to avoid messing up the user's terminal.
      */
     void shutdown();
@@ -34,4 +61,45 @@ namespace kontra::terminal {
      */
     void read_input_events(std::vector<InputEvent>& events);
 
+    /**
+     * \brief Tells the caller of wait() why it woke up. More than one can be set.
+     */
+    struct WakeReasons {
+        bool input = false;   ///< There are bytes waiting on stdin.
+        bool resize = false;  ///< The terminal may have been resized (SIGWINCH on POSIX).
+        bool wakeup = false;  ///< Someone called wake().
+        bool output = false;  ///< stdout can take more bytes (only checked when asked for).
+    };
+
+    /**
+     * \brief Blocks until there is input, a resize, a wake() call, or the timeout runs out.
+     * \param timeout_ms How long to wait at most, or -1 to wait forever.
+     * \param want_output Also wake up when stdout becomes writable again.
+     * \return Which of the above happened, all false on timeout.
+     */
+    WakeReasons wait(int timeout_ms, bool want_output = false);
+
+    /**
+     * \brief Makes a pending or future wait() return right away.
+     * Safe to call from other threads and from signal handlers.
+     */
+    void wake();
+
+    /**
+     * \brief Returns the terminal size as {columns, rows}.
+     *
+     * The size is cached and only asked from the terminal again after wait() has reported
+     * a resize, so calling this every frame costs nothing.
+     */
+    std::pair<int, int> size();
+
+    /**
+     * \brief True once the terminal has answered ansi::QUERY_SYNCHRONIZED_UPDATE saying it
+     * knows synchronized output (mode 2026). False before an answer arrives, and forever on
+     * terminals that ignore the query.
+     *
+     * The answer comes in on stdin and is picked up (and swallowed) by read_input_events().
+     */
+    bool synchronized_output_supported();
+
 } 
\ No newline at end of file
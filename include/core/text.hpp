@@ -7,8 +7,11 @@
  *********************************************************************/
 #pragma once
 #include "component.hpp"
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <functional>
+#include <vector>
 
 struct TextStyle {
 	std::string color;
@@ -30,6 +33,15 @@ struct TextStyle {
 		italic(is_italic)
 	{
 	}
+
+	bool operator==(const TextStyle& other) const {
+		return bold == other.bold && underline == other.underline && italic == other.italic
+			&& color == other.color && background_color == other.background_color;
+	}
+
+	bool operator!=(const TextStyle& other) const {
+		return !(*this == other);
+	}
 };
 
 /**
@@ -113,25 +125,74 @@ struct StyleBuilder {
 };
 
 class Text : public Component {
-	std::function<std::string()> text;
+	std::function<std::string()> text; // empty for static text, which lives in `content` for good
 	TextStyle style;
-	mutable std::string last_rendered_value;
+
+	// What the provider returned this frame. Parents ask for the height several times per
+	// frame and then render, so the provider is called at most once per frame, and the wrap
+	// layout is only rebuilt when the text or the width actually changed.
+	struct LineSpan {
+		std::uint32_t begin = 0;
+		std::uint32_t length = 0;
+	};
+	mutable std::string content;
+	mutable std::uint64_t content_generation = 0;
+	mutable std::uint64_t content_epoch = ~std::uint64_t(0);
+	std::uint64_t drawn_generation = ~std::uint64_t(0); // content_generation of the last render
+
+	mutable std::vector<LineSpan> lines;
+	mutable std::uint64_t layout_generation = ~std::uint64_t(0);
+	mutable int layout_width = -1;
+
+	// Display width of the longest line, for the content_generation it was worked out for.
+	mutable int natural_width = 0;
+	mutable std::uint64_t natural_width_generation = ~std::uint64_t(0);
+
+	// The style interned once, not rebuilt from its strings on every render.
+	mutable StyleId text_style_id = StyleRegistry::RESET_ID;
+	mutable StyleId bg_style_id = StyleRegistry::RESET_ID;
+	mutable bool style_interned = false;
+
+	const std::string& current_text() const;
+	const std::vector<LineSpan>& layout(int width) const;
+	void intern_style() const;
 public:
 
 	// Following is only for static test, simply a literal passed.
 	// I mean something like dis: Text("Hello, world!");
 	Text(const std::string& value, const TextStyle& style = TextStyle())
-		: text([value]() { return value; }), style(style) {
+		: style(style), content(value) {
 	}
 
 	// Following is for dynamic text. I guess u can say text passed as a function (a callback function ?)
 	// For example something like this: Text([&]() { return "Hello, " + name; });
 	Text(std::function<std::string()> provider, const TextStyle& style = TextStyle())
 		: text(std::move(provider)), style(style) {
+		set_polling(true);
 	}
 
+	/**
+	 * @brief Replaces the text with a fixed string (dropping any provider).
+	 * Setting the same text again is free, so widgets can call this every frame.
+	 * @param value The new text.
+	 */
+	Text& set_text(std::string_view value);
+
+	/**
+	 * @brief Changes the style. Setting the same style again is free, so widgets can call this every frame.
+	 * @param new_style The new style.
+	 */
+	Text& set_style(const TextStyle& new_style);
+
 	// See core/component.hpp 
 	int get_preferred_height(int width) const;
+	bool caches_layout() const override { return true; }
+
+	// See core/component.hpp, the longest line.
+	int get_preferred_width() const override;
+
+	// See core/component.hpp, calls the provider and reports whether its text changed.
+	bool poll() override;
 
 	/**
 	 * @brief Renders the input box at the specified position and size.
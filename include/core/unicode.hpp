@@ -0,0 +1,126 @@
+/*****************************************************************//**
+ * \file   unicode.hpp
+ * \brief  Splits UTF-8 text into the clusters that each take one or two terminal cells.
+ *
+ * Widgets used to walk their strings byte by byte and put every byte into its own cell,
+ * which cut multi-byte characters in half and drew CJK text and emoji at the wrong width.
+ *
+ * Text is instead read one grapheme cluster at a time: a base character together with
+ * anything that draws on top of it (combining accents, variation selectors, skin tone
+ * modifiers, zero width joiner sequences, flag pairs). Each cluster comes back with the
+ * glyph handle to store in a cell and the number of columns it covers, so layout and
+ * rendering agree on where everything goes. draw_text() is the one place that puts
+ * clusters into cells, wide ones as a glyph followed by a glyph::CONTINUATION cell.
+ *
+ * The widths come from a table of East Asian Wide/Fullwidth and zero width ranges,
+ * indexed at compile time by 256 code point pages so most lookups are a single load.
+ *
+ * \author parv141206
+ * \date   October 2026
+ *********************************************************************/
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include "glyph.hpp"
+#include "screen_buffer.hpp"
+
+namespace unicode {
+
+	/// What malformed UTF-8 decodes to.
+	inline constexpr char32_t REPLACEMENT = 0xFFFD;
+
+	/**
+	 * \brief Decodes the code point starting at `pos` and moves `pos` past it.
+	 *
+	 * Malformed or truncated sequences decode to REPLACEMENT and consume a single byte,
+	 * so decoding always makes progress. `pos` must be less than `text.size()`.
+	 */
+	inline char32_t decode(std::string_view text, size_t& pos) {
+		const unsigned char c = static_cast<unsigned char>(text[pos]);
+		if (c < 0x80) {
+			pos++;
+			return c;
+		}
+
+		size_t len;
+		char32_t cp;
+		if (c >= 0xC2 && c < 0xE0) { len = 2; cp = c & 0x1F; }
+		else if (c >= 0xE0 && c < 0xF0) { len = 3; cp = c & 0x0F; }
+		else if (c >= 0xF0 && c < 0xF5) { len = 4; cp = c & 0x07; }
+		else { pos++; return REPLACEMENT; }
+
+		if (pos + len > text.size()) { pos++; return REPLACEMENT; }
+		for (size_t i = 1; i < len; ++i) {
+			const unsigned char cc = static_cast<unsigned char>(text[pos + i]);
+			if ((cc & 0xC0) != 0x80) { pos++; return REPLACEMENT; }
+			cp = (cp << 6) | (cc & 0x3F);
+		}
+
+		// Overlong forms, surrogates and anything past U+10FFFF.
+		if ((len == 3 && (cp < 0x800 || (cp >= 0xD800 && cp < 0xE000))) || (len == 4 && (cp < 0x10000 || cp > 0x10FFFF))) {
+			pos++;
+			return REPLACEMENT;
+		}
+		pos += len;
+		return cp;
+	}
+
+	/// Slow path of codepoint_width(), for everything outside Latin-1.
+	int codepoint_width_slow(char32_t cp);
+
+	/**
+	 * \brief Number of columns a code point takes on its own.
+	 * \return 2 for wide characters, 1 for most, 0 for ones that combine with the previous
+	 * character, and -1 for control characters, which have no width at all.
+	 */
+	inline int codepoint_width(char32_t cp) {
+		if (cp >= 0x20 && cp < 0x7F) return 1;
+		if (cp < 0x20 || (cp >= 0x7F && cp < 0xA0)) return -1;
+		if (cp < 0x300) return 1;
+		return codepoint_width_slow(cp);
+	}
+
+	/// One grapheme cluster of a string.
+	struct Cluster {
+		size_t length = 0; ///< Bytes in the cluster.
+		int width = 1;     ///< Columns it covers, 1 or 2.
+		Glyph glyph = glyph::SPACE;
+	};
+
+	/// Slow path of next_cluster(), for anything that is not plain ASCII.
+	Cluster next_cluster_slow(std::string_view text, size_t pos);
+
+	/**
+	 * \brief Reads the grapheme cluster starting at `pos`, which must be less than `text.size()`.
+	 *
+	 * Control characters (tabs, stray escapes) come back as a one column space, so they can
+	 * never move the terminal cursor.
+	 */
+	inline Cluster next_cluster(std::string_view text, size_t pos) {
+		const unsigned char c = static_cast<unsigned char>(text[pos]);
+		// ASCII followed by ASCII (or nothing) is a cluster of its own, which is almost all text.
+		if (c >= 0x20 && c < 0x7F && (pos + 1 == text.size() || static_cast<unsigned char>(text[pos + 1]) < 0x80)) {
+			return { 1, 1, c };
+		}
+		return next_cluster_slow(text, pos);
+	}
+
+	/// Columns covered by the first cluster of `cluster`, without interning anything.
+	int cluster_width(std::string_view cluster);
+
+	/// Columns `text` takes when drawn on one line.
+	int display_width(std::string_view text);
+
+	/**
+	 * \brief Draws `text` into a span from ScreenBuffer::span(), one cluster per cell, wide
+	 * clusters as a glyph and a glyph::CONTINUATION cell.
+	 *
+	 * Columns count from the start of the run that was asked for, clipped part included, and
+	 * the text starts at `column`. A wide cluster cut in half by either edge is drawn as a
+	 * space. Nothing past the end of the span is read.
+	 *
+	 * \return The column just after the last cluster that was (at least partly) drawn.
+	 */
+	int draw_text(CellSpan span, std::string_view text, StyleId style, int column = 0);
+}
@@ -0,0 +1,146 @@
+/*****************************************************************//**
+ * \file   virtual_list.hpp
+ * \brief  A scrolling list that only has components for the rows on screen.
+ *
+ * List needs every row to exist up front as a component, so a million entries means a
+ * million heap allocated components. VirtualList instead asks a data source how many rows
+ * there are, keeps a small pool of row components (one per visible row, plus one) and
+ * points them at whatever rows are on screen each frame. Memory is O(visible rows), no
+ * matter how big the data set is.
+ *
+ * \author parv141206
+ * \date   October 2026
+ *********************************************************************/
+#pragma once
+#include "component.hpp"
+#include "text.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief Where a VirtualList gets its rows from.
+ *
+ * create_row() makes an empty row component, which the list keeps and reuses. bind_row()
+ * points one of those components at a row of the data, and is called for every visible row
+ * on every frame, so it should be cheap when nothing changed (Text::set_text and
+ * Text::set_style are free when given the current value).
+ */
+class VirtualListSource {
+public:
+	virtual ~VirtualListSource() = default;
+
+	/// Number of rows in the data.
+	virtual size_t row_count() const = 0;
+
+	/// Makes a new row component. Only called until the pool covers the visible rows.
+	virtual std::shared_ptr<Component> create_row() = 0;
+
+	/// Shows row `index` in `row`, a component made by create_row().
+	virtual void bind_row(Component& row, size_t index) = 0;
+};
+
+/**
+ * @brief A list of equally tall rows that are created on demand and recycled.
+ *
+ * Example
+ * ```cpp
+ * std::vector<std::string> lines = load_log();
+ *
+ * auto log = std::make_shared<VirtualList>(
+ *     [&]() { return lines.size(); },
+ *     [&](Text& row, size_t i) { row.set_text(lines[i]); }
+ * );
+ * ```
+ */
+class VirtualList : public Component {
+	std::shared_ptr<VirtualListSource> source;
+	int row_height = 1;
+	int scroll_offset = 0; // in lines, not rows
+	bool scrollbar_enabled = true;
+	size_t reveal_row = SIZE_MAX; // row to scroll into view on the next render
+
+	// Row components, row `i` is always drawn by pool[i % pool.size()] so a row keeps its
+	// component (and whatever that caches) while it stays on screen.
+	std::vector<std::shared_ptr<Component>> pool;
+
+	// Where the rows went in the last frame, for row_at().
+	size_t first_drawn = 0;
+	int first_drawn_y = 0;
+	size_t drawn_count = 0;
+	size_t drawn_rows = 0; // row_count() as of the last render
+
+public:
+	/**
+	 * @brief A list backed by a data source.
+	 * @param source Provides the row count and the row components.
+	 */
+	explicit VirtualList(std::shared_ptr<VirtualListSource> source);
+
+	/**
+	 * @brief A list of one line Text rows.
+	 * @param row_count Returns the number of rows.
+	 * @param bind_text Fills in a Text for row `index`: its text and, if you like, its style.
+	 */
+	VirtualList(std::function<size_t()> row_count, std::function<void(Text& row, size_t index)> bind_text);
+
+	/**
+	 * @brief Sets how many lines every row takes. Defaults to 1.
+	 * @param lines The row height.
+	 */
+	VirtualList& set_row_height(int lines);
+
+	/**
+	 * @brief Enables or disables the scrollbar shown when the rows do not fit.
+	 * @param enabled Set to true to show the scrollbar.
+	 */
+	VirtualList& set_scrollbar_enabled(bool enabled);
+
+	/**
+	 * @brief Scrolls up by a number of lines.
+	 * @param amount Lines to scroll.
+	 */
+	void scroll_up(int amount = 1);
+
+	/**
+	 * @brief Scrolls down by a number of lines.
+	 * @param amount Lines to scroll.
+	 */
+	void scroll_down(int amount = 1);
+
+	/**
+	 * @brief Scrolls just enough to show row `index` on the next render.
+	 * @param index The row to show.
+	 */
+	void scroll_to_row(size_t index);
+
+	/**
+	 * @brief Finds the row under the mouse, using the positions from the last render.
+	 * @return The row index, or -1 if the point is not on a row.
+	 */
+	long long row_at(int mouse_x, int mouse_y) const;
+
+	/// Number of row components alive right now, which is about the number of visible rows.
+	size_t pool_size() const { return pool.size(); }
+
+	// See core/component.hpp
+	int get_preferred_height(int width) const override;
+	bool caches_layout() const override { return true; }
+
+	/**
+	 * @brief Notices rows being added or removed. Edits to rows that are already there cannot
+	 * be seen from here, so in a retained Screen call mark_dirty() after making one.
+	 */
+	bool poll() override;
+
+	/**
+	 * @brief Renders the rows that are on screen.
+	 * @param x The x-coordinate of the list's position.
+	 * @param y The y-coordinate of the list's position.
+	 * @param w The width of the list.
+	 * @param h The height of the list.
+	 */
+	void render(ScreenBuffer& buffer, int x, int y, int w, int h) override;
+};
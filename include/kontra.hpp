@@ -1,13 +1,17 @@
 #pragma once
 #include "./core/component.hpp"
 #include "./core/runtime.hpp"
+#include "./core/frame_scheduler.hpp"
 #include "./core/ansi.hpp"
 #include "./core/utils.hpp"
 #include "./core/flex.hpp"
+#include "./core/grid.hpp"
 #include "./core/screen.hpp"
 #include "./core/text.hpp"
 #include "./core/border.hpp"
 #include "./core/list.hpp"
+#include "./core/virtual_list.hpp"
+#include "./core/table.hpp"
 #include "./core/input_box.hpp"
 #include "./core/button.hpp"
 #include "./core/input.hpp"
@@ -18,3 +22,4 @@
 #include "./core/radio.hpp"
 #include "./core/radio-group.hpp"
 #include "./core/tabs.hpp"
+#include "./core/unicode.hpp"
@@ -6,6 +6,7 @@
 
 #include "core/ansi.hpp"
 #include "core/screen_buffer.hpp"
+#include "core/unicode.hpp"
 #include "core/utils.hpp"
 
 #ifdef _WIN32
@@ -14,52 +15,60 @@
 #endif
 
 void Border::set_child(std::shared_ptr<Component> child_component) {
+  release_children();
   child = std::move(child_component);
+  adopt(child.get());
+  invalidate_layout();
 }
 
 int Border::get_preferred_height(int width) const {
   int inner_width = width > 2 ? width - 2 - (2 * padding) : 0;
   int child_height = 0;
   if (child) {
-    child_height = child->get_preferred_height(inner_width);
+    child_height = child->measure(inner_width);
   }
   return child_height + 2 + (2 * padding);
 }
 
+int Border::get_preferred_width() const {
+  return (child ? child->get_preferred_width() : 0) + 2 + (2 * padding);
+}
+
 Border& Border::set_padding(int p) {
   padding = p;
+  invalidate_layout();
   return *this;
 }
 
+Cell Border::backdrop() const {
+  if (style.background_color.empty()) return Component::backdrop();
+  return {glyph::SPACE,
+          StyleRegistry::intern(style.color + style.background_color)};
+}
+
 void Border::render(ScreenBuffer& buffer, int x, int y, int w, int h) {
   Component::render(buffer, x, y, w, h);
-  std::string full_style = style.color + style.background_color;
+  const StyleId full_style =
+      StyleRegistry::intern(style.color + style.background_color);
   const auto& chars = style.characters;
+  const Glyph v = glyph::from_utf8(chars.v);
+  const Glyph hz = glyph::from_utf8(chars.h);
 
   if (w < 2 || h < 2) return;
 
   if (!style.background_color.empty()) {
-    for (int i = 0; i < h; ++i) {
-      for (int j = 0; j < w; ++j) {
-        buffer.set_cell(x + j, y + i, " ", full_style);
-      }
-    }
+    buffer.fill_rect(x, y, w, h, {glyph::SPACE, full_style});
   }
 
-  for (int i = 1; i < h - 1; ++i) {
-    buffer.set_cell(x, y + i, chars.v, full_style);
-    buffer.set_cell(x + w - 1, y + i, chars.v, full_style);
-  }
-  for (int j = 1; j < w - 1; ++j) {
-    buffer.set_cell(x + j, y + h - 1, chars.h, full_style);
-  }
+  // Top and bottom edges are whole runs, the sides are one cell per row.
+  buffer.fill_rect(x + 1, y, w - 2, 1, {hz, full_style});
+  buffer.fill_rect(x + 1, y + h - 1, w - 2, 1, {hz, full_style});
+  buffer.fill_rect(x, y + 1, 1, h - 2, {v, full_style});
+  buffer.fill_rect(x + w - 1, y + 1, 1, h - 2, {v, full_style});
 
-  if (style.title.empty() || style.title.length() > w - 4) {
-    for (int j = 1; j < w - 1; ++j)
-      buffer.set_cell(x + j, y, chars.h, full_style);
-  } else {
-    std::string display_title = " " + style.title + " ";
-    int title_len = display_title.length();
+  const int title_width = unicode::display_width(style.title);
+  if (!style.title.empty() && title_width <= w - 4) {
+    int title_len = title_width + 2;  // a space on either side
     int title_start_col =
         (style.title_alignment == TitleAlignment::Left)
             ? 2
@@ -67,19 +76,15 @@ void Border::render(ScreenBuffer& buffer, int x, int y, int w, int h) {
                    ? w - title_len - 2
                    : (w - title_len) / 2);
 
-    for (int j = 1; j < title_start_col; ++j)
-      buffer.set_cell(x + j, y, chars.h, full_style);
-    for (int j = 0; j < title_len; ++j)
-      buffer.set_cell(x + title_start_col + j, y,
-                      std::string(1, display_title[j]), full_style);
-    for (int j = title_start_col + title_len; j < w - 1; ++j)
-      buffer.set_cell(x + j, y, chars.h, full_style);
+    CellSpan title_span = buffer.span(x + title_start_col, y, title_len);
+    title_span.fill({glyph::SPACE, full_style});
+    unicode::draw_text(title_span, style.title, full_style, 1);
   }
 
-  buffer.set_cell(x, y, chars.tl, full_style);
-  buffer.set_cell(x + w - 1, y, chars.tr, full_style);
-  buffer.set_cell(x, y + h - 1, chars.bl, full_style);
-  buffer.set_cell(x + w - 1, y + h - 1, chars.br, full_style);
+  buffer.set_cell(x, y, glyph::from_utf8(chars.tl), full_style);
+  buffer.set_cell(x + w - 1, y, glyph::from_utf8(chars.tr), full_style);
+  buffer.set_cell(x, y + h - 1, glyph::from_utf8(chars.bl), full_style);
+  buffer.set_cell(x + w - 1, y + h - 1, glyph::from_utf8(chars.br), full_style);
 
   if (child) {
     int innerX = x + 1;
@@ -12,11 +12,18 @@ int Box::get_preferred_height(int width) const {
     }
     if (child) {
         int child_width = (fixed_width != -1) ? fixed_width : width;
-        return child->get_preferred_height(child_width);
+        return child->measure(child_width);
     }
     return 1;
 }
 
+int Box::get_preferred_width() const {
+    if (fixed_width != -1) {
+        return fixed_width;
+    }
+    return child ? child->get_preferred_width() : 0;
+}
+
 void Box::render(ScreenBuffer& buffer, int x, int y, int w, int h)  {
     Component::render(buffer, x, y, w, h);
 
@@ -2,7 +2,10 @@
 
 void Button::set_active(bool is_active)
 {
-	active = is_active;
+	if (active != is_active) {
+		active = is_active;
+		mark_dirty();
+	}
 }
 
 bool Button::is_active() const
@@ -18,17 +21,13 @@ void Button::click()
 
 int Button::get_preferred_height(int width) const
 {
-	Text temp_renderer(label_provider(), TextStyle());
-	return temp_renderer.get_preferred_height(width);
+	return label_text.measure(width);
 }
 
 void Button::render(ScreenBuffer &buffer, int x, int y, int w, int h)
 {
 	Component::render(buffer, x, y, w, h);
     
-    const TextStyle& current_text_style = is_active() ? style.active_style : style.inactive_style;
-
-	Text text_renderer(label_provider(), current_text_style);
-
-	text_renderer.render(buffer, x, y, w, h);
+	label_text.set_style(is_active() ? style.active_style : style.inactive_style);
+	label_text.render(buffer, x, y, w, h);
 }
@@ -1,7 +1,11 @@
 #include "core/checkbox.hpp"
+#include <algorithm>
 
 void Checkbox::set_active(bool is_active) {
-	active = is_active;
+	if (active != is_active) {
+		active = is_active;
+		mark_dirty();
+	}
 }
 
 bool Checkbox::is_active() const {
@@ -11,13 +15,17 @@ bool Checkbox::is_active() const {
 void Checkbox::toggle() {
 	if (target_variable) {
 		*target_variable = !(*target_variable);
+		mark_dirty();
 	}
 }
 
+bool Checkbox::poll() {
+	return target_variable && *target_variable != drawn_checked;
+}
+
 int Checkbox::get_preferred_height(int width) const {
     int label_width = (width > 4) ? width - 4 : 0;
-    Text temp_renderer(label_provider(), TextStyle());
-    return temp_renderer.get_preferred_height(label_width);
+    return label_text.measure(label_width);
 }
 
 void Checkbox::render(ScreenBuffer& buffer, int x, int y, int w, int h) {
@@ -25,10 +33,11 @@ void Checkbox::render(ScreenBuffer& buffer, int x, int y, int w, int h) {
 
 	const TextStyle& current_style = active ? style.active : style.normal;
 
-	std::string box_text = (target_variable && *target_variable) ? "[x] " : "[ ] ";
-	
-    std::string full_text = box_text + label_provider();
-    
-    Text text_renderer(full_text, current_style);
-	text_renderer.render(buffer, x, y, w, h);
+	// The marker takes the first four columns, the label wraps in the rest.
+	drawn_checked = target_variable && *target_variable;
+	marker.set_text(drawn_checked ? "[x] " : "[ ] ").set_style(current_style);
+	marker.render(buffer, x, y, std::min(w, 4), h);
+
+	label_text.set_style(current_style);
+	label_text.render(buffer, x + 4, y, w - 4, h);
 }
@@ -1,2 +1,67 @@
-// I dont think this file would be required
-#include "core/component.hpp"
\ No newline at end of file
+#include "core/component.hpp"
+
+void Component::refresh() {
+    if (!polls_below) return;
+    if (polls && poll()) mark_dirty();
+    // Its size is not cached, so whatever its ancestors arranged around it is stale too.
+    if (!caches_layout()) drop_layout();
+    refresh_children();
+}
+
+void Component::refresh_children() {
+    for (size_t i = 0, n = child_count(); i < n; ++i) {
+        Component* child = child_at(i);
+        if (child) child->refresh();
+    }
+}
+
+bool Component::repaint(ScreenBuffer& buffer) {
+    if (dirty) {
+        redraw(buffer);
+        return true;
+    }
+    if (!child_dirty) return false;
+    if (layout_moved()) {
+        redraw(buffer);
+        return true;
+    }
+
+    bool drew = false;
+    const auto [first, end] = drawn_children();
+    for (size_t i = first; i < end; ++i) {
+        // Children drawn by this component's last render are at least as new as it is. Older
+        // ones (scrolled out of a List, on another tab) are not on screen.
+        Component* child = child_at(i);
+        if (!child || child->painted_frame < painted_frame || !(child->dirty || child->child_dirty)) continue;
+
+        // A child that changed size, or that sticks out of this component, cannot be redrawn
+        // on its own without touching its neighbours.
+        bool inside = child->last_x >= last_x && child->last_y >= last_y &&
+                      child->last_x + child->last_w <= last_x + last_w &&
+                      child->last_y + child->last_h <= last_y + last_h;
+        if (!inside || child_needs_layout(*child)) {
+            redraw(buffer);
+            return true;
+        }
+        drew |= child->repaint(buffer);
+    }
+    child_dirty = false;
+    return drew;
+}
+
+void Component::redraw(ScreenBuffer& buffer) {
+    buffer.fill_rect(last_x, last_y, last_w, last_h, backdrop());
+    render(buffer, last_x, last_y, last_w, last_h);
+    settle();
+}
+
+void Component::settle() {
+    dirty = false;
+    child_dirty = false;
+    const auto [first, end] = drawn_children();
+    for (size_t i = first; i < end; ++i) {
+        Component* child = child_at(i);
+        if (!child || child->painted_frame < painted_frame) continue;
+        child->settle();
+    }
+}
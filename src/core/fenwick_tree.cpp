@@ -0,0 +1,60 @@
+#include "core/fenwick_tree.hpp"
+
+namespace {
+    size_t lowbit(size_t i) { return i & (~i + 1); }
+}
+
+void FenwickTree::assign(const std::vector<int>& new_values) {
+    values = new_values;
+    tree.assign(values.size() + 1, 0);
+
+    // Each node passes its sum on to its parent once, which builds the tree in O(n).
+    for (size_t i = 1; i < tree.size(); ++i) {
+        tree[i] += values[i - 1];
+        size_t parent = i + lowbit(i);
+        if (parent < tree.size()) tree[parent] += tree[i];
+    }
+}
+
+void FenwickTree::push_back(int value) {
+    values.push_back(value);
+    size_t i = values.size();
+
+    // The new node covers (i - lowbit(i), i], which is the new value plus the values
+    // before it that it is responsible for.
+    tree.push_back(value + prefix(i - 1) - prefix(i - lowbit(i)));
+}
+
+void FenwickTree::set(size_t index, int value) {
+    long long delta = (long long)value - values[index];
+    if (delta == 0) return;
+    values[index] = value;
+    for (size_t i = index + 1; i < tree.size(); i += lowbit(i)) {
+        tree[i] += delta;
+    }
+}
+
+long long FenwickTree::prefix(size_t count) const {
+    long long sum = 0;
+    for (size_t i = count; i > 0; i -= lowbit(i)) {
+        sum += tree[i];
+    }
+    return sum;
+}
+
+size_t FenwickTree::find(long long offset) const {
+    if (offset < 0) return 0;
+
+    // Walk down from the biggest power of two, skipping every block that ends at or before `offset`.
+    size_t step = 1;
+    while (step * 2 < tree.size()) step *= 2;
+
+    size_t pos = 0;
+    for (; step > 0; step /= 2) {
+        if (pos + step < tree.size() && tree[pos + step] <= offset) {
+            pos += step;
+            offset -= tree[pos];
+        }
+    }
+    return pos; // `pos` values fit entirely before `offset`, so it lands in the next one
+}
@@ -1,54 +1,239 @@
 #include "core/flex.hpp"
 #include "core/ansi.hpp"
+#include <algorithm>
+
+#ifdef _WIN32
+#undef min
+#undef max
+#endif
 
 void Flex::add(std::shared_ptr<Component> comp) {
+	add(std::move(comp), FlexItem());
+}
+
+void Flex::add(std::shared_ptr<Component> comp, const FlexItem& item) {
 	children.push_back(std::move(comp));
+	items.push_back(item);
+	adopt(children.back().get());
+}
+
+Flex& Flex::set_item(size_t index, const FlexItem& item) {
+	if (index < items.size()) {
+		items[index] = item;
+		invalidate_layout();
+	}
+	return *this;
+}
+
+Flex& Flex::set_align(FlexAlign a) {
+	align = a;
+	invalidate_layout();
+	return *this;
+}
+
+Flex& Flex::set_justify(FlexJustify j) {
+	justify = j;
+	invalidate_layout();
+	return *this;
 }
 
 Flex& Flex::set_gap(int g) {
 	gap = g;
+	invalidate_layout();
 	return *this;
 }
 
 Flex& Flex::set_padding(int p) {
 	padding = p;
+	invalidate_layout();
 	return *this;
 }
 
 void Flex::clear() {
+	release_children();
 	children.clear();
+	items.clear();
+	invalidate_layout();
 }
 
-void Flex::render(ScreenBuffer& buffer, int x, int y, int w, int h) {
-	Component::render(buffer, x, y, w, h);
-	int count = children.size();
-	if (count == 0) return;
+int Flex::basis_of(size_t index, int cross) const {
+	const FlexItem& item = items[index];
+	int basis = item.basis;
+	if (basis == FlexItem::AUTO) {
+		basis = direction == FlexDirection::Column ? children[index]->measure(cross) : children[index]->get_preferred_width();
+	}
+	return std::clamp(basis, std::max(item.min, 0), std::max(item.max, item.min));
+}
+
+// Sizes every child along the direction so they fill `available`, the way CSS flexbox does:
+// start from the bases, then share out the space left over (by grow) or missing (by shrink
+// times basis). A child pushed past its min or max is frozen there and the round is redone
+// without it, so this loops at most once per child. Without min/max it is a single pass.
+// The result is in `sizes`; the return value is the space nobody took (or, if negative,
+// what did not fit even after shrinking).
+int Flex::solve(int available, int cross) const {
+	const size_t count = children.size();
+	bases.resize(count);
+	sizes.resize(count);
+	targets.resize(count);
+	frozen.assign(count, 0);
+	for (size_t i = 0; i < count; ++i) {
+		bases[i] = sizes[i] = basis_of(i, cross);
+	}
+
+	while (true) {
+		long long free = available;
+		for (int size : sizes) free -= size;
+		if (free == 0) return 0;
+
+		const bool growing = free > 0;
+		auto factor = [&](size_t i) -> long long {
+			return growing ? items[i].grow : (long long)items[i].shrink * bases[i];
+		};
 
-	int innerX = x + padding;
-	int innerY = y + padding;
-	int innerW = w - (2 * padding);
-	int innerH = h - (2 * padding);
+		long long total = 0;
+		size_t unfrozen = 0;
+		for (size_t i = 0; i < count; ++i) {
+			if (frozen[i]) continue;
+			if (factor(i) <= 0) frozen[i] = 1;
+			else {
+				total += factor(i);
+				unfrozen++;
+			}
+		}
+		if (total == 0) return (int)free;
+
+		// Every share is rounded down, then the cells that are left go one each to the first
+		// children when growing, and are taken one each from the last ones when shrinking. The
+		// shares add up to exactly the space there is, and a tight layout keeps its first children.
+		const long long magnitude = growing ? free : -free;
+		long long remainder = magnitude;
+		for (size_t i = 0; i < count; ++i) {
+			if (!frozen[i]) remainder -= factor(i) * magnitude / total;
+		}
+		const size_t first_extra = growing ? 0 : unfrozen - (size_t)remainder;
+		const size_t end_extra = growing ? (size_t)remainder : unfrozen;
+
+		size_t k = 0;
+		bool clamped = false;
+		for (size_t i = 0; i < count; ++i) {
+			if (frozen[i]) continue;
+			long long share = factor(i) * magnitude / total;
+			if (k >= first_extra && k < end_extra) share++;
+			k++;
 
+			long long target = sizes[i] + (growing ? share : -share);
+			int limited = (int)std::clamp<long long>(target, std::max(items[i].min, 0), std::max(items[i].max, items[i].min));
+			if (limited != target) {
+				sizes[i] = limited;
+				frozen[i] = 1;
+				clamped = true;
+			}
+			else {
+				targets[i] = (int)target;
+			}
+		}
+		if (clamped) continue; // share out again among the children that are still free
+
+		for (size_t i = 0; i < count; ++i) {
+			if (!frozen[i]) sizes[i] = targets[i];
+		}
+		return 0;
+	}
+}
+
+void Flex::arrange(int w, int h) {
+	if (arranged_w == w && arranged_h == h && arranged_generation == get_layout_generation() && slots.size() == children.size()) return;
+
+	const int count = (int)children.size();
+	slots.resize(count);
+	arranged_w = w;
+	arranged_h = h;
+	if (count == 0) {
+		arranged_generation = get_layout_generation();
+		return;
+	}
+
+	const bool row = direction == FlexDirection::Row;
+	const int innerW = std::max(w - (2 * padding), 0);
+	const int innerH = std::max(h - (2 * padding), 0);
+	const int main = row ? innerW : innerH;
+	const int cross = row ? innerH : innerW;
+	const int totalGap = gap * (count - 1);
+
+	const int leftover = std::max(solve(std::max(main - totalGap, 0), cross), 0);
+
+	int pos = padding;
+	if (justify == FlexJustify::Center) pos += leftover / 2;
+	else if (justify == FlexJustify::End) pos += leftover;
+
+	for (int i = 0; i < count; ++i) {
+		// Children that could not shrink enough are cut off at the far edge.
+		int size = std::clamp(padding + main - pos, 0, sizes[i]);
+
+		int cross_pos = 0;
+		int cross_size = cross;
+		if (align != FlexAlign::Stretch) {
+			cross_size = std::min(row ? children[i]->measure(size) : children[i]->get_preferred_width(), cross);
+			if (align == FlexAlign::Center) cross_pos = (cross - cross_size) / 2;
+			else if (align == FlexAlign::End) cross_pos = cross - cross_size;
+		}
+
+		slots[i] = row ? Slot{ pos, padding + cross_pos, size, cross_size }
+		               : Slot{ padding + cross_pos, pos, cross_size, size };
+
+		pos += sizes[i] + gap;
+		if (justify == FlexJustify::SpaceBetween && count > 1 && i < count - 1) {
+			pos += leftover * (i + 1) / (count - 1) - leftover * i / (count - 1);
+		}
+	}
+	arranged_generation = get_layout_generation(); // after measuring, a provider may have bumped it
+}
+
+int Flex::get_preferred_height(int width) const {
+	const int count = (int)children.size();
+	if (count == 0) return 2 * padding;
+
+	const int innerW = std::max(width - (2 * padding), 0);
+	int total = 0;
 	if (direction == FlexDirection::Column) {
-		int totalGap = gap * (count - 1);
-		int availableHeight = innerH - totalGap;
-		int childHeight = availableHeight > 0 ? availableHeight / count : 0;
-		int currentY = innerY;
-		for (const auto& child : children) {
-			if (currentY >= y + h) break;
-			child->render(buffer, innerX, currentY, innerW, childHeight);
-			currentY += childHeight + gap;
+		for (int i = 0; i < count; ++i) {
+			const FlexItem& item = items[i];
+			int size = basis_of(i, innerW);
+			// A child that grows would take all the room its content needs.
+			if (item.grow > 0) {
+				size = std::clamp(children[i]->measure(innerW), size, std::max(item.max, size));
+			}
+			total += size;
 		}
+		total += gap * (count - 1);
 	}
 	else {
-		int totalGap = gap * (count - 1);
-		int availableWidth = innerW - totalGap;
-		int childWidth = availableWidth > 0 ? availableWidth / count : 0;
-		int currentX = innerX;
-		for (const auto& child : children) {
-			if (currentX >= x + w) break;
-			child->render(buffer, currentX, innerY, childWidth, innerH);
-			currentX += childWidth + gap;
+		solve(std::max(innerW - gap * (count - 1), 0), 0);
+		for (int i = 0; i < count; ++i) {
+			total = std::max(total, children[i]->measure(sizes[i]));
 		}
 	}
+	return total + 2 * padding;
+}
+
+bool Flex::child_needs_layout(const Component& child) const {
+	// Only children sized by their content move anything else around when they change.
+	for (size_t i = 0; i < children.size(); ++i) {
+		if (children[i].get() != &child) continue;
+		if (align != FlexAlign::Stretch) return true;
+		return direction == FlexDirection::Column && items[i].basis == FlexItem::AUTO;
+	}
+	return false;
+}
+
+void Flex::render(ScreenBuffer& buffer, int x, int y, int w, int h) {
+	Component::render(buffer, x, y, w, h);
+	arrange(w, h);
+
+	for (size_t i = 0; i < children.size(); ++i) {
+		const Slot& slot = slots[i];
+		if (slot.w <= 0 || slot.h <= 0) continue;
+		children[i]->render(buffer, x + slot.x, y + slot.y, slot.w, slot.h);
+	}
 }
\ No newline at end of file
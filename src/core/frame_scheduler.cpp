@@ -0,0 +1,46 @@
+#include "core/frame_scheduler.hpp"
+
+FrameScheduler& FrameScheduler::set_target_fps(int fps) {
+    target_fps = fps > 0 ? fps : 0;
+    return *this;
+}
+
+FrameScheduler& FrameScheduler::set_min_frame_interval(std::chrono::milliseconds interval) {
+    min_interval = interval.count() > 0 ? interval : std::chrono::milliseconds(0);
+    return *this;
+}
+
+FrameScheduler::Clock::duration FrameScheduler::period() const {
+    Clock::duration p = min_interval;
+    if (target_fps > 0) {
+        Clock::duration fps_period = std::chrono::duration_cast<Clock::duration>(std::chrono::seconds(1)) / target_fps;
+        if (fps_period > p) p = fps_period;
+    }
+    return p;
+}
+
+bool FrameScheduler::frame_due(Clock::time_point now) const {
+    return (requested || target_fps > 0) && now >= next_frame;
+}
+
+int FrameScheduler::wait_timeout_ms(Clock::time_point now) const {
+    if (!requested && target_fps == 0) return -1;
+    if (now >= next_frame) return 0;
+
+    // Round up, waking a little late is fine but waking early just means spinning.
+    auto left = next_frame - now;
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(left);
+    if (ms < left) ++ms;
+    return static_cast<int>(ms.count());
+}
+
+void FrameScheduler::begin_frame(Clock::time_point now) {
+    requested = false;
+
+    // Keep to the deadline grid so render time does not add up, but if we have fallen more
+    // than a whole period behind (the app was idle, or a frame took very long), start over
+    // from now instead of firing a burst of frames to catch up.
+    Clock::duration p = period();
+    Clock::time_point start = (now - next_frame < p) ? next_frame : now;
+    next_frame = start + p;
+}
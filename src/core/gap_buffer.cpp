@@ -0,0 +1,116 @@
+#include "core/gap_buffer.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+    size_t count_non_ascii(const char* data, size_t size) {
+        size_t count = 0;
+        for (size_t i = 0; i < size; ++i) {
+            if (static_cast<unsigned char>(data[i]) >= 0x80) count++;
+        }
+        return count;
+    }
+}
+
+void GapBuffer::move_gap(size_t pos) const {
+    if (pos < gap_begin) {
+        // Slide the characters in [pos, gap_begin) to the far side of the gap.
+        size_t count = gap_begin - pos;
+        std::memmove(storage.data() + gap_end - count, storage.data() + pos, count);
+        gap_begin -= count;
+        gap_end -= count;
+    }
+    else if (pos > gap_begin) {
+        size_t count = pos - gap_begin;
+        std::memmove(storage.data() + gap_begin, storage.data() + gap_end, count);
+        gap_begin += count;
+        gap_end += count;
+    }
+}
+
+void GapBuffer::reserve_gap(size_t needed) {
+    if (gap_size() >= needed) return;
+
+    // Grow geometrically so a long run of inserts stays O(1) amortized.
+    size_t length = size();
+    size_t capacity = std::max<size_t>({ 64, storage.size() * 2, length + needed });
+    size_t tail = storage.size() - gap_end;
+
+    std::vector<char> grown(capacity);
+    std::memcpy(grown.data(), storage.data(), gap_begin);
+    std::memcpy(grown.data() + capacity - tail, storage.data() + gap_end, tail);
+    storage.swap(grown);
+    gap_end = capacity - tail;
+}
+
+void GapBuffer::insert(size_t pos, std::string_view s) {
+    if (s.empty()) return;
+    pos = std::min(pos, size());
+
+    reserve_gap(s.size());
+    move_gap(pos);
+    std::memcpy(storage.data() + gap_begin, s.data(), s.size());
+    gap_begin += s.size();
+    non_ascii += count_non_ascii(s.data(), s.size());
+
+    // Shift the line breaks after the insert, then open a hole for the new ones and fill it.
+    auto it = std::lower_bound(newlines.begin(), newlines.end(), pos);
+    for (auto shift = it; shift != newlines.end(); ++shift) *shift += s.size();
+    size_t added = static_cast<size_t>(std::count(s.begin(), s.end(), '\n'));
+    if (added > 0) {
+        it = newlines.insert(it, added, 0);
+        for (size_t i = 0; i < s.size(); ++i) {
+            if (s[i] == '\n') *it++ = pos + i;
+        }
+    }
+
+    edit_generation++;
+}
+
+void GapBuffer::erase(size_t pos, size_t count) {
+    size_t length = size();
+    if (pos >= length || count == 0) return;
+    count = std::min(count, length - pos);
+
+    move_gap(pos);
+    non_ascii -= count_non_ascii(storage.data() + gap_end, count);
+    gap_end += count;
+
+    auto first = std::lower_bound(newlines.begin(), newlines.end(), pos);
+    auto last = std::lower_bound(first, newlines.end(), pos + count);
+    for (auto shift = last; shift != newlines.end(); ++shift) *shift -= count;
+    newlines.erase(first, last);
+
+    edit_generation++;
+}
+
+void GapBuffer::assign(std::string_view s) {
+    storage.assign(s.begin(), s.end());
+    gap_begin = gap_end = storage.size();
+    non_ascii = count_non_ascii(s.data(), s.size());
+
+    newlines.clear();
+    for (size_t i = 0; i < s.size(); ++i) {
+        if (s[i] == '\n') newlines.push_back(i);
+    }
+
+    edit_generation++;
+}
+
+std::string_view GapBuffer::slice(size_t pos, size_t count, std::string& scratch) const {
+    const size_t length = size();
+    pos = std::min(pos, length);
+    count = std::min(count, length - pos);
+
+    if (pos + count <= gap_begin) return std::string_view(storage.data() + pos, count);
+    if (pos >= gap_begin) return std::string_view(storage.data() + pos + gap_size(), count);
+
+    scratch.assign(storage.data() + pos, gap_begin - pos);
+    scratch.append(storage.data() + gap_end, pos + count - gap_begin);
+    return scratch;
+}
+
+std::string_view GapBuffer::view() const {
+    move_gap(size());
+    return std::string_view(storage.data(), gap_begin);
+}
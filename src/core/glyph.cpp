@@ -0,0 +1,85 @@
+#include "core/glyph.hpp"
+#include "core/unicode.hpp"
+#include <deque>
+#include <unordered_map>
+
+namespace {
+    // Clusters live in a deque so the string_view keys never dangle when it grows.
+    struct ClusterTable {
+        std::deque<std::string> clusters;
+        std::deque<std::uint8_t> widths;
+        std::unordered_map<std::string_view, Glyph> ids;
+    };
+
+    ClusterTable& cluster_table() {
+        static ClusterTable table;
+        return table;
+    }
+
+    // Decodes exactly one well-formed code point, returns false for anything else.
+    bool decode_single(std::string_view s, Glyph& cp) {
+        unsigned char c = static_cast<unsigned char>(s[0]);
+        size_t len;
+        if (c < 0x80) { cp = c; len = 1; }
+        else if ((c & 0xE0) == 0xC0) { cp = c & 0x1F; len = 2; }
+        else if ((c & 0xF0) == 0xE0) { cp = c & 0x0F; len = 3; }
+        else if ((c & 0xF8) == 0xF0) { cp = c & 0x07; len = 4; }
+        else return false;
+
+        if (s.size() != len) return false;
+        for (size_t i = 1; i < len; ++i) {
+            unsigned char cc = static_cast<unsigned char>(s[i]);
+            if ((cc & 0xC0) != 0x80) return false;
+            cp = (cp << 6) | (cc & 0x3F);
+        }
+        return cp < 0x110000;
+    }
+}
+
+namespace glyph {
+
+    Glyph from_utf8_slow(std::string_view utf8) {
+        Glyph cp;
+        if (decode_single(utf8, cp)) return cp;
+
+        auto& table = cluster_table();
+        auto it = table.ids.find(utf8);
+        if (it != table.ids.end()) return it->second;
+
+        Glyph id = CLUSTER_BIT | static_cast<Glyph>(table.clusters.size());
+        const std::string& stored = table.clusters.emplace_back(utf8);
+        table.widths.push_back(static_cast<std::uint8_t>(unicode::cluster_width(utf8) == 2 ? 2 : 1));
+        table.ids.emplace(stored, id);
+        return id;
+    }
+
+    int width_slow(Glyph g) {
+        if (g & CLUSTER_BIT) return cluster_table().widths[g & ~CLUSTER_BIT];
+        return unicode::codepoint_width(g) == 2 ? 2 : 1;
+    }
+
+    void append_utf8(std::string& out, Glyph g) {
+        if (g & CLUSTER_BIT) {
+            out += cluster_table().clusters[g & ~CLUSTER_BIT];
+            return;
+        }
+        if (g < 0x80) {
+            out += static_cast<char>(g);
+        }
+        else if (g < 0x800) {
+            out += static_cast<char>(0xC0 | (g >> 6));
+            out += static_cast<char>(0x80 | (g & 0x3F));
+        }
+        else if (g < 0x10000) {
+            out += static_cast<char>(0xE0 | (g >> 12));
+            out += static_cast<char>(0x80 | ((g >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (g & 0x3F));
+        }
+        else {
+            out += static_cast<char>(0xF0 | (g >> 18));
+            out += static_cast<char>(0x80 | ((g >> 12) & 0x3F));
+            out += static_cast<char>(0x80 | ((g >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (g & 0x3F));
+        }
+    }
+}
@@ -0,0 +1,193 @@
+#include "core/grid.hpp"
+#include <algorithm>
+
+#ifdef _WIN32
+#undef min
+#undef max
+#endif
+
+Grid::Grid(std::vector<GridTrack> columns, std::vector<GridTrack> rows)
+	: columns(std::move(columns)), rows(std::move(rows)) {}
+
+Grid& Grid::add(std::shared_ptr<Component> child, int row, int column, int row_span, int column_span) {
+	cells.push_back({ std::move(child), row, column, std::max(row_span, 1), std::max(column_span, 1) });
+	adopt(cells.back().child.get());
+	return *this;
+}
+
+Grid& Grid::set_gap(int rows, int columns) {
+	row_gap = std::max(rows, 0);
+	column_gap = std::max(columns, 0);
+	invalidate_layout();
+	return *this;
+}
+
+Grid& Grid::set_padding(int p) {
+	padding = std::max(p, 0);
+	invalidate_layout();
+	return *this;
+}
+
+void Grid::clear() {
+	release_children();
+	cells.clear();
+	invalidate_layout();
+}
+
+int Grid::span_size(const std::vector<int>& sizes, int gap, int first, int span) const {
+	int total = gap * (span - 1);
+	for (int i = first; i < first + span; ++i) total += sizes[i];
+	return total;
+}
+
+// Sizes the columns (or rows) into `sizes` and returns their total, gaps included. Rows are
+// measured at the width of the columns they cover, which `widths` holds.
+// With `fill`, fraction tracks share whatever is left of `available`. Without it there is
+// no space to share, so they are sized by their content like auto tracks, which is what
+// the preferred sizes want.
+int Grid::size_tracks(bool horizontal, std::vector<int>& sizes, const std::vector<int>& widths, int available, bool fill) const {
+	const std::vector<GridTrack>& tracks = horizontal ? columns : rows;
+	const int count = (int)tracks.size();
+	const int gap = horizontal ? column_gap : row_gap;
+	sizes.assign(count, 0);
+	if (count == 0) return 0;
+
+	auto by_content = [&](int i) {
+		return tracks[i].kind == GridTrack::Kind::Auto || (!fill && tracks[i].kind == GridTrack::Kind::Fraction);
+	};
+	for (int i = 0; i < count; ++i) {
+		if (tracks[i].kind == GridTrack::Kind::Fixed) sizes[i] = std::max(tracks[i].value, 0);
+	}
+
+	// Single cells first, then spans push out whatever content tracks they cover by the
+	// space they are still missing. Spans over a fraction track can take room from it instead.
+	for (int pass = 0; pass < 2; ++pass) {
+		for (const Placement& cell : cells) {
+			const int first = horizontal ? cell.column : cell.row;
+			if (first < 0 || first >= count) continue;
+			const int span = std::min(horizontal ? cell.column_span : cell.row_span, count - first);
+			if ((span > 1) != (pass == 1)) continue;
+
+			int flexible = 0;
+			bool fraction = false;
+			for (int i = first; i < first + span; ++i) {
+				if (by_content(i)) flexible++;
+				else if (tracks[i].kind == GridTrack::Kind::Fraction) fraction = true;
+			}
+			if (flexible == 0 || fraction) continue;
+
+			int content;
+			if (horizontal) {
+				content = cell.child->get_preferred_width();
+			}
+			else {
+				if (cell.column < 0 || cell.column >= (int)widths.size()) continue;
+				content = cell.child->measure(span_size(widths, column_gap, cell.column, std::min(cell.column_span, (int)widths.size() - cell.column)));
+			}
+
+			const int missing = content - span_size(sizes, gap, first, span);
+			if (missing <= 0) continue;
+			int seen = 0;
+			for (int i = first; i < first + span; ++i) {
+				if (!by_content(i)) continue;
+				sizes[i] += missing * (seen + 1) / flexible - missing * seen / flexible;
+				seen++;
+			}
+		}
+	}
+
+	int total = span_size(sizes, gap, 0, count);
+	if (!fill) return total;
+
+	long long weights = 0;
+	for (const GridTrack& track : tracks) {
+		if (track.kind == GridTrack::Kind::Fraction) weights += std::max(track.value, 0);
+	}
+	const int free = available - total;
+	if (weights == 0 || free <= 0) return total;
+
+	// Cumulative rounding, so the fractions add up to exactly the space that was left.
+	long long weight = 0;
+	for (int i = 0; i < count; ++i) {
+		if (tracks[i].kind != GridTrack::Kind::Fraction) continue;
+		const long long before = weight * free / weights;
+		weight += std::max(tracks[i].value, 0);
+		sizes[i] = (int)(weight * free / weights - before);
+	}
+	return available;
+}
+
+void Grid::arrange(int inner_w, int inner_h) {
+	const std::uint64_t generation = get_layout_generation();
+	if (sized_width != inner_w || columns_generation != generation) {
+		size_tracks(true, column_sizes, column_sizes, inner_w, true);
+		sized_width = inner_w;
+		sized_height = -1;
+		columns_generation = get_layout_generation();
+
+		column_starts.resize(column_sizes.size());
+		for (size_t i = 0, pos = 0; i < column_sizes.size(); ++i) {
+			column_starts[i] = (int)pos;
+			pos += column_sizes[i] + column_gap;
+		}
+	}
+	if (sized_height != inner_h || rows_generation != get_layout_generation()) {
+		size_tracks(false, row_sizes, column_sizes, inner_h, true);
+		sized_height = inner_h;
+		rows_generation = get_layout_generation(); // after measuring, a provider may have bumped it
+
+		row_starts.resize(row_sizes.size());
+		for (size_t i = 0, pos = 0; i < row_sizes.size(); ++i) {
+			row_starts[i] = (int)pos;
+			pos += row_sizes[i] + row_gap;
+		}
+	}
+}
+
+int Grid::get_preferred_width() const {
+	return size_tracks(true, scratch_columns, scratch_columns, 0, false) + 2 * padding;
+}
+
+int Grid::get_preferred_height(int width) const {
+	const int innerW = std::max(width - (2 * padding), 0);
+	size_tracks(true, scratch_columns, scratch_columns, innerW, true);
+	return size_tracks(false, scratch_rows, scratch_columns, 0, false) + 2 * padding;
+}
+
+bool Grid::child_needs_layout(const Component& child) const {
+	// A child in an auto track can change the size of its row or column, and so move every
+	// other child in them. Everywhere else its cell stays put whatever it draws.
+	for (const Placement& cell : cells) {
+		if (cell.child.get() != &child) continue;
+		for (int i = std::max(cell.column, 0); i < std::min(cell.column + cell.column_span, (int)columns.size()); ++i) {
+			if (columns[i].kind == GridTrack::Kind::Auto) return true;
+		}
+		for (int i = std::max(cell.row, 0); i < std::min(cell.row + cell.row_span, (int)rows.size()); ++i) {
+			if (rows[i].kind == GridTrack::Kind::Auto) return true;
+		}
+	}
+	return false;
+}
+
+void Grid::render(ScreenBuffer& buffer, int x, int y, int w, int h) {
+	Component::render(buffer, x, y, w, h);
+	const int innerW = std::max(w - (2 * padding), 0);
+	const int innerH = std::max(h - (2 * padding), 0);
+	arrange(innerW, innerH);
+
+	const int column_count = (int)columns.size();
+	const int row_count = (int)rows.size();
+	for (const Placement& cell : cells) {
+		if (cell.row < 0 || cell.row >= row_count || cell.column < 0 || cell.column >= column_count) continue;
+		const int column_span = std::min(cell.column_span, column_count - cell.column);
+		const int row_span = std::min(cell.row_span, row_count - cell.row);
+
+		// Tracks that did not fit are cut off at the far edge.
+		const int left = column_starts[cell.column];
+		const int top = row_starts[cell.row];
+		const int cw = std::min(span_size(column_sizes, column_gap, cell.column, column_span), innerW - left);
+		const int ch = std::min(span_size(row_sizes, row_gap, cell.row, row_span), innerH - top);
+		if (cw <= 0 || ch <= 0) continue;
+		cell.child->render(buffer, x + padding + left, y + padding + top, cw, ch);
+	}
+}
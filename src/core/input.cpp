@@ -7,7 +7,7 @@ int Input::get_preferred_height(int width) const {
 	int total = 0;
 	if (!children.empty()) {
 		for (const auto& child : children) {
-			total += child->get_preferred_height(absWidth);
+			total += child->measure(absWidth);
 		}
 		total += gap * (children.size() - 1);
 	}
@@ -17,30 +17,38 @@ int Input::get_preferred_height(int width) const {
 
 void Input::add(std::shared_ptr<InputBox> inputBox) {
 	children.push_back(std::move(inputBox));
+	adopt(children.back().get());
 }
 
 void Input::clear() {
-
+	release_children();
 	children.clear();
+	invalidate_layout();
 }
 
 Input& Input::set_gap(int g) {
 	gap = g;
+	invalidate_layout();
 	return *this;
 }
 
 Input& Input::set_padding(int p) {
 	padding = p;
+	invalidate_layout();
 	return *this;
 }
 
+bool Input::child_needs_layout(const Component& child) const {
+	return child.measure(child.last_w) != child.last_h;
+}
+
 
 void Input::render(ScreenBuffer& buffer, int x, int y, int w, int h) {
 	Component::render(buffer, x, y, w, h);
 	int currentY = y + padding;
 	int inner_w = w - (2 * padding);
 	for (const auto& child : children) {
-		int child_h = child->get_preferred_height(inner_w);
+		int child_h = child->measure(inner_w);
 		if (currentY + child_h > y + h) break;
 		child->render(buffer, x + padding, currentY, inner_w, child_h);
 		currentY += child_h + gap;
@@ -1,40 +1,156 @@
 ﻿#include "core/input_box.hpp"
 #include "core/ansi.hpp"
 #include "core/utils.hpp"
+#include "core/unicode.hpp"
 #include <iostream>
 #include <cctype>
 #include <algorithm>
+#include <climits>
+#include <cstdint>
 #ifdef _WIN32
 #undef min
 #undef max
 #endif
 
-int InputBox::get_preferred_height(int width) const {
-	if (width <= 2) return 3;
-	int innerW = width - 2;
-	if (!wrap) return 3;
+unicode::Cluster InputBox::cluster_across_gap(size_t pos, size_t end) const {
+	// Look at a small window and widen it until the cluster visibly ends inside it. A code
+	// point cut off by the window edge could still belong to the cluster, hence the 4 bytes.
+	size_t window = 16;
+	while (true) {
+		const size_t count = std::min(window, end - pos);
+		const std::string_view piece = text.slice(pos, count, cluster_scratch);
+		unicode::Cluster c = unicode::next_cluster(piece, 0);
+		if (c.length + 4 <= piece.size() || count == end - pos) return c;
+		window *= 2;
+	}
+}
+
+InputBox::WrapPos InputBox::walk(size_t begin, size_t end, int width, size_t stop_offset, int stop_row) const {
+	if (text.is_ascii()) {
+		// One byte, one column: plain arithmetic.
+		size_t offset = std::min(end, stop_offset);
+		if (stop_row != INT_MAX) offset = std::min(offset, begin + (size_t)stop_row * width);
+		int row = (int)((offset - begin) / width);
+		return { offset, row, (int)((offset - begin) % width) };
+	}
+
+	// Clusters fill a row left to right. A row that is full moves on to the next right away,
+	// and a wide cluster that would stick out starts the next row instead.
+	// The line as it sits on either side of the gap, so clusters are read where they are.
+	const std::string_view before = text.before_gap();
+	const size_t split = before.size();
+	const std::string_view head = before.substr(0, std::min(end, split));
+	const std::string_view tail = end > split ? text.after_gap().substr(0, end - split) : std::string_view();
 
-	int lines = 1;
-	int currentLineLength = 0;
-	for (char c : text) {
-		if (c == '\n') {
-			lines++;
-			currentLineLength = 0;
+	size_t offset = begin;
+	int row = 0, col = 0;
+	while (offset < end && row < stop_row) {
+		unicode::Cluster c = offset >= split ? unicode::next_cluster(tail, offset - split) : unicode::next_cluster(head, offset);
+		if (offset < split && end > split && offset + c.length + 4 > split) c = cluster_across_gap(offset, end);
+		if (col > 0 && col + c.width > width) {
+			row++;
+			col = 0;
+			if (row >= stop_row) break;
 		}
-		else {
-			currentLineLength++;
-			if (currentLineLength >= innerW) {
-				lines++;
-				currentLineLength = 0;
-			}
+		if (offset >= stop_offset) break;
+		col += c.width;
+		offset += c.length;
+		if (col >= width) {
+			row++;
+			col = 0;
 		}
 	}
-	return lines + 2;
+	return { offset, row, col };
+}
+
+size_t InputBox::previous_boundary(size_t pos) const {
+	if (pos == 0) return 0;
+	if (text.is_ascii()) return pos - 1;
+
+	// Clusters can only be found going forward, so walk from the start of the line.
+	const std::vector<size_t>& breaks = text.line_breaks();
+	auto it = std::lower_bound(breaks.begin(), breaks.end(), pos);
+	size_t line_start = it == breaks.begin() ? 0 : *(it - 1) + 1;
+	if (line_start == pos) return pos - 1; // the line break itself
+	size_t line_end = it == breaks.end() ? text.size() : *it;
+
+	size_t previous = line_start;
+	for (size_t at = line_start; at < pos; at += cluster_at(at, line_end).length) {
+		previous = at;
+	}
+	return previous;
+}
+
+size_t InputBox::next_boundary(size_t pos) const {
+	if (pos >= text.size()) return text.size();
+	if (text.is_ascii() || text[pos] == '\n') return pos + 1;
+	return pos + cluster_at(pos, text.size()).length;
+}
+
+void InputBox::update_layout(int innerW) const {
+	if (layout_generation == text.generation() && layout_width == innerW) return;
+
+	// Every logical line takes one row, plus one more each time it fills the whole width.
+	// The buffer already knows where the line breaks are, so ASCII text is per line, not per char.
+	const std::vector<size_t>& breaks = text.line_breaks();
+	line_rows.resize(breaks.size() + 1);
+	int rows = 0;
+	size_t line_start = 0;
+	for (size_t i = 0; i <= breaks.size(); ++i) {
+		size_t line_end = i < breaks.size() ? breaks[i] : text.size();
+		line_rows[i] = rows;
+		rows += 1 + walk(line_start, line_end, innerW).row;
+		line_start = line_end + 1;
+	}
+	total_rows = rows;
+
+	layout_generation = text.generation();
+	layout_width = innerW;
+}
+
+void InputBox::update_view(int innerW) const {
+	if (view_generation == text.generation() && view_cursor == cursor && view_width == innerW) return;
+
+	view_cursor_col = walk(0, text.size(), INT_MAX, (size_t)cursor).col;
+	view_first_col = 0;
+	if (view_cursor_col >= innerW) {
+		view_first_col = view_cursor_col - innerW + 1;
+		view_cursor_col = innerW - 1;
+	}
+
+	// Find where column view_first_col starts. A wide glyph cut by the left edge starts at -1.
+	size_t from = 0;
+	int col = 0;
+	if (text.is_ascii()) {
+		from = std::min((size_t)view_first_col, text.size());
+		col = (int)from;
+	}
+	while (from < text.size() && col < view_first_col) {
+		unicode::Cluster c = cluster_at(from, text.size());
+		if (col + c.width > view_first_col) break;
+		col += c.width;
+		from += c.length;
+	}
+	view_offset = from;
+	view_offset_col = col - view_first_col;
+
+	view_generation = text.generation();
+	view_cursor = cursor;
+	view_width = innerW;
+}
+
+int InputBox::get_preferred_height(int width) const {
+	if (width <= 2) return 3;
+	if (!wrap) return 3;
+
+	update_layout(width - 2);
+	return total_rows + 2;
 }
 
 void InputBox::set_active(bool is_active) {
 	if (active != is_active) {
 		active = is_active;
+		mark_dirty();
 	}
 }
 
@@ -44,137 +160,177 @@ bool InputBox::is_active() const {
 
 void InputBox::set_wrap_enabled(bool enabled) {
 	wrap = enabled;
+	invalidate_layout();
 }
 
 std::string InputBox::get_text() const {
-	return text;
+	return text.str();
+}
+
+std::string_view InputBox::text_view() const {
+	return text.view();
 }
 
 void InputBox::set_label(const std::string& label_text) {
     label = label_text;
+    mark_dirty();
 }
 
 void InputBox::set_text(const std::string& new_text) {
-    text = new_text;
+    text.assign(new_text);
     cursor = std::min(cursor, (int)text.size());
+    invalidate_layout();
 }
 
 void InputBox::handle_input(char ch) {
 	if (!active) return;
+	invalidate_layout();
 
 	switch (ch) {
 	case '\b': case 127:
 		if (cursor > 0) {
-			text.erase(cursor - 1, 1);
-			cursor--;
+			size_t previous = previous_boundary(cursor);
+			text.erase(previous, cursor - previous);
+			cursor = (int)previous;
 		}
 		break;
 	case 27:
 		break;
 	case 75:
-		if (cursor > 0) cursor--;
+		cursor = (int)previous_boundary(cursor);
 		break;
 	case 77:
-		if (cursor < (int)text.size()) cursor++;
+		cursor = (int)next_boundary(cursor);
 		break;
 	default:
-		if (std::isprint(static_cast<unsigned char>(ch))) {
-			text.insert(cursor, 1, ch);
+		// Bytes of multi-byte UTF-8 characters arrive one key press at a time.
+		if (std::isprint(static_cast<unsigned char>(ch)) || static_cast<unsigned char>(ch) >= 0x80) {
+			text.insert(cursor, ch);
 			cursor++;
 		}
 		break;
 	}
 }
 
+void InputBox::insert_text(std::string_view pasted) {
+	if (!active || pasted.empty()) return;
+
+	// Filter first and insert once: inserting character by character shifts the tail of
+	// the text every time, which made pasting anything big quadratic.
+	std::string accepted;
+	accepted.reserve(pasted.size());
+	for (char ch : pasted) {
+		if (ch == '\n' || ch == '\r' || ch == '\t') {
+			accepted += ' ';
+		}
+		else if (std::isprint(static_cast<unsigned char>(ch)) || static_cast<unsigned char>(ch) >= 0x80) {
+			accepted += ch;
+		}
+	}
+
+	text.insert(cursor, accepted);
+	cursor += (int)accepted.size();
+	invalidate_layout();
+}
 
 void InputBox::render(ScreenBuffer& buffer, int x, int y, int w, int h) {
     Component::render(buffer, x, y, w, h);
-    const std::string border_style = ansi::RESET;
-    const std::string text_style = ansi::RESET;
-    const std::string cursor_style = ansi::INVERSE;
+    if (w < 2 || h < 2) return;
+
+    const StyleId border_style = StyleRegistry::RESET_ID;
+    const StyleId text_style = StyleRegistry::RESET_ID;
+    const StyleId cursor_style = StyleRegistry::intern(ansi::INVERSE);
+    const Glyph hz = glyph::from_utf8(ansi::h), v = glyph::from_utf8(ansi::v);
+
+    // Frame first, the same way Border draws it.
+    buffer.fill_rect(x + 1, y, w - 2, 1, { hz, border_style });
+    buffer.fill_rect(x + 1, y + h - 1, w - 2, 1, { hz, border_style });
+    buffer.fill_rect(x, y + 1, 1, h - 2, { v, border_style });
+    buffer.fill_rect(x + w - 1, y + 1, 1, h - 2, { v, border_style });
+    buffer.set_cell(x, y, glyph::from_utf8(ansi::tl), border_style);
+    buffer.set_cell(x + w - 1, y, glyph::from_utf8(ansi::tr), border_style);
+    buffer.set_cell(x, y + h - 1, glyph::from_utf8(ansi::bl), border_style);
+    buffer.set_cell(x + w - 1, y + h - 1, glyph::from_utf8(ansi::br), border_style);
+
+    const int label_width = unicode::display_width(label);
+    if (!label.empty() && label_width <= w - 4) {
+        CellSpan label_span = buffer.span(x + 2, y, label_width + 2); // always left aligned
+        label_span.fill({ glyph::SPACE, border_style });
+        unicode::draw_text(label_span, label, border_style, 1);
+    }
 
     const int innerW = w - 2;
+    const int innerH = h - 2;
+    if (innerW <= 0 || innerH <= 0) return;
+
+    // Where the cursor sits, in rows and columns of the wrapped (or scrolled) text.
+    int cursor_row = 0;
+    int cursor_col = 0;
+    if (wrap) {
+        update_layout(innerW);
+        const std::vector<size_t>& breaks = text.line_breaks();
+        size_t line = std::lower_bound(breaks.begin(), breaks.end(), (size_t)cursor) - breaks.begin();
+        size_t line_start = line == 0 ? 0 : breaks[line - 1] + 1;
+        size_t line_end = line < breaks.size() ? breaks[line] : text.size();
+        WrapPos at = walk(line_start, line_end, innerW, (size_t)cursor);
+        cursor_row = line_rows[line] + at.row;
+        cursor_col = at.col;
+    }
+    else {
+        update_view(innerW);
+        cursor_col = view_cursor_col;
+    }
+
+    // Scroll just enough to keep the cursor row on screen.
+    if (cursor_row < scroll_row) scroll_row = cursor_row;
+    if (cursor_row >= scroll_row + innerH) scroll_row = cursor_row - innerH + 1;
+    if (!wrap) scroll_row = 0;
+
+    // Only the visible rows are looked at. Consecutive rows of one line continue where the
+    // previous one stopped, so a long line is walked once per frame, not once per row.
+    size_t prev_line = SIZE_MAX;
+    int prev_row_in_line = -1;
+    size_t prev_to = 0;
+    for (int r = 0; r < innerH; ++r) {
+        CellSpan row = buffer.span(x + 1, y + 1 + r, innerW);
+        row.fill({ glyph::SPACE, text_style });
 
-    for (int i = 0; i < h; ++i) {
-        for (int j = 0; j < w; ++j) {
-            const int current_x = x + j;
-            const int current_y = y + i;
-
-            const bool is_top = (i == 0);
-            const bool is_bottom = (i == h - 1);
-            const bool is_left = (j == 0);
-            const bool is_right = (j == w - 1);
-
-            if (is_top && is_left) { buffer.set_cell(current_x, current_y, ansi::tl, border_style); continue; }
-            if (is_top && is_right) { buffer.set_cell(current_x, current_y, ansi::tr, border_style); continue; }
-            if (is_bottom && is_left) { buffer.set_cell(current_x, current_y, ansi::bl, border_style); continue; }
-            if (is_bottom && is_right) { buffer.set_cell(current_x, current_y, ansi::br, border_style); continue; }
-            if (is_bottom) { buffer.set_cell(current_x, current_y, ansi::h, border_style); continue; }
-            if (is_left || is_right) { buffer.set_cell(current_x, current_y, ansi::v, border_style); continue; }
-
-            if (is_top) {
-                if (label.empty() || label.length() > w - 4) {
-                    buffer.set_cell(current_x, current_y, ansi::h, border_style);
-                }
-                else {
-                    std::string display_label = " " + label + " ";
-                    int label_len = display_label.length();
-                    int label_start_col = 2; // Always align left for input boxes
-
-                    if (j >= label_start_col && j < label_start_col + label_len) {
-                        buffer.set_cell(current_x, current_y, std::string(1, display_label[j - label_start_col]), border_style);
-                    }
-                    else {
-                        buffer.set_cell(current_x, current_y, ansi::h, border_style);
-                    }
-                }
-                continue;
-            }
-
-            const int content_row = i - 1;
-            const int content_col = j - 1;
-            wchar_t char_to_draw = L' ';
-            std::string style_to_use = text_style;
-
-            if (wrap) {
-                int text_pos = content_row * innerW + content_col;
-                if (text_pos < text.length()) {
-                    char_to_draw = text[text_pos];
-                }
-            }
-            else {
-                if (content_row == 0) {
-                    int scroll_offset = 0;
-                    if (cursor >= innerW) {
-                        scroll_offset = cursor - innerW + 1;
-                    }
-                    int text_pos = scroll_offset + content_col;
-                    if (text_pos < text.length()) {
-                        char_to_draw = text[text_pos];
-                    }
-                }
-            }
-
-            if (active) {
-                int cursor_row_actual = wrap ? (cursor / innerW) : 0;
-                int cursor_col_actual;
-                if (wrap) {
-                    cursor_col_actual = cursor % innerW;
-                }
-                else {
-                    int scroll_offset = 0;
-                    if (cursor >= innerW) {
-                        scroll_offset = cursor - innerW + 1;
-                    }
-                    cursor_col_actual = cursor - scroll_offset;
-                }
-
-                if (content_row == cursor_row_actual && content_col == cursor_col_actual) {
-                    style_to_use = cursor_style;
-                }
-            }
-
-            buffer.set_cell(current_x, current_y, std::string(1, char_to_draw), style_to_use);
+        if (!wrap) {
+            if (r > 0) continue;
+            // Only as much as fits, so a long line is not copied when the gap is in it.
+            size_t to = walk(view_offset, text.size(), innerW - view_offset_col, SIZE_MAX, 1).offset;
+            unicode::draw_text(row, text.slice(view_offset, to - view_offset, row_scratch), text_style, view_offset_col);
+            continue;
         }
+
+        int visual_row = scroll_row + r;
+        if (visual_row >= total_rows) continue;
+        const std::vector<size_t>& breaks = text.line_breaks();
+        size_t line = std::upper_bound(line_rows.begin(), line_rows.end(), visual_row) - line_rows.begin() - 1;
+        size_t line_start = line == 0 ? 0 : breaks[line - 1] + 1;
+        size_t line_end = line < breaks.size() ? breaks[line] : text.size();
+        int row_in_line = visual_row - line_rows[line];
+
+        size_t from = (line == prev_line && row_in_line == prev_row_in_line + 1)
+            ? prev_to
+            : walk(line_start, line_end, innerW, SIZE_MAX, row_in_line).offset;
+        size_t to = walk(from, line_end, innerW, SIZE_MAX, 1).offset;
+        prev_line = line;
+        prev_row_in_line = row_in_line;
+        prev_to = to;
+
+        unicode::draw_text(row, text.slice(from, to - from, row_scratch), text_style);
     }
-}
\ No newline at end of file
+
+    if (active) {
+        int cursor_screen_row = cursor_row - scroll_row;
+        if (cursor_screen_row >= 0 && cursor_screen_row < innerH) {
+            size_t under_end = next_boundary(cursor);
+            std::string_view under = text.slice(cursor, under_end - cursor, row_scratch);
+            if (under.empty() || under == "\n") under = " ";
+            CellSpan cell = buffer.span(x + 1 + cursor_col, y + 1 + cursor_screen_row,
+                                        std::min(unicode::display_width(under), innerW - cursor_col));
+            unicode::draw_text(cell, under, cursor_style);
+        }
+    }
+}
@@ -0,0 +1,302 @@
+#include "core/input_parser.hpp"
+#include <array>
+#include <utility>
+
+namespace {
+    // Byte classes inside a CSI sequence, straight from the VT500 parser diagram.
+    enum ByteClass : std::uint8_t {
+        CONTROL,      // 0x00-0x1F, ESC is handled before the table is consulted
+        INTERMEDIATE, // 0x20-0x2F, like '$' in a mode report
+        DIGIT,        // 0x30-0x39
+        SEPARATOR,    // ';' and ':'
+        MARKER,       // '<' '=' '>' '?', only meaningful as the first byte
+        FINAL,        // 0x40-0x7E, ends the sequence
+        IGNORED,      // DEL and everything above 0x7F
+    };
+
+    constexpr std::array<std::uint8_t, 256> make_byte_classes() {
+        std::array<std::uint8_t, 256> table{};
+        for (int c = 0; c < 256; ++c) {
+            if (c < 0x20) table[c] = CONTROL;
+            else if (c < 0x30) table[c] = INTERMEDIATE;
+            else if (c < 0x3A) table[c] = DIGIT;
+            else if (c < 0x3C) table[c] = SEPARATOR;
+            else if (c < 0x40) table[c] = MARKER;
+            else if (c < 0x7F) table[c] = FINAL;
+            else table[c] = IGNORED;
+        }
+        return table;
+    }
+
+    constexpr std::array<std::uint8_t, 256> byte_classes = make_byte_classes();
+
+    constexpr char PASTE_END[] = "\033[201~";
+    constexpr int PASTE_END_LENGTH = sizeof(PASTE_END) - 1;
+
+    // Big enough for any real parameter, small enough to never overflow.
+    constexpr int PARAM_LIMIT = 100000;
+}
+
+void InputParser::feed(const char* data, size_t size, std::vector<InputEvent>& events) {
+    for (size_t i = 0; i < size; ++i) {
+        feed(data[i], events);
+    }
+}
+
+void InputParser::feed(char byte, std::vector<InputEvent>& events) {
+    unsigned char c = static_cast<unsigned char>(byte);
+
+    switch (state) {
+    case State::GROUND:
+        ground(c, events);
+        return;
+
+    case State::ESCAPE:
+        if (c == '[') {
+            start_csi();
+        }
+        else if (c == 'O') {
+            state = State::SS3;
+        }
+        else if (c == 27) {
+            events.push_back(InputEvent::keyboard(EventType::KEY_ESCAPE)); // ESC ESC, the second may start a sequence
+        }
+        else {
+            // ESC followed by a plain key (Alt+key on most terminals): report both.
+            events.push_back(InputEvent::keyboard(EventType::KEY_ESCAPE));
+            state = State::GROUND;
+            ground(c, events);
+        }
+        return;
+
+    case State::CSI:
+        if (c == 27) {
+            state = State::ESCAPE; // a new sequence interrupts an unfinished one
+            return;
+        }
+        switch (byte_classes[c]) {
+        case DIGIT:
+            if (param_count == 0) param_count = 1;
+            if (param_count <= MAX_PARAMS) {
+                int& p = params[param_count - 1];
+                if (p < PARAM_LIMIT) p = p * 10 + (c - '0');
+            }
+            return;
+        case SEPARATOR:
+            if (param_count == 0) param_count = 1;
+            if (param_count < MAX_PARAMS) params[param_count] = 0;
+            param_count++;
+            return;
+        case MARKER:
+            if (param_count == 0 && prefix == 0 && intermediate == 0) prefix = c;
+            return;
+        case INTERMEDIATE:
+            intermediate = c;
+            return;
+        case FINAL:
+            state = State::GROUND;
+            dispatch_csi(c, events);
+            return;
+        default:
+            return; // stray control bytes and DEL are ignored, like a real terminal does
+        }
+
+    case State::SS3:
+        state = State::GROUND;
+        switch (c) {
+        case 'A': events.push_back(InputEvent::keyboard(EventType::KEY_UP)); return;
+        case 'B': events.push_back(InputEvent::keyboard(EventType::KEY_DOWN)); return;
+        case 'C': events.push_back(InputEvent::keyboard(EventType::KEY_RIGHT)); return;
+        case 'D': events.push_back(InputEvent::keyboard(EventType::KEY_LEFT)); return;
+        case 'M': events.push_back(InputEvent::keyboard(EventType::KEY_ENTER)); return; // keypad Enter
+        case 27: state = State::ESCAPE; return;
+        default: return; // F1-F4 and friends have no event yet
+        }
+
+    case State::PASTE:
+        paste(c, events);
+        return;
+    }
+}
+
+void InputParser::ground(unsigned char c, std::vector<InputEvent>& events) {
+    switch (c) {
+    case 27:
+        state = State::ESCAPE;
+        return;
+    case 10:
+    case 13:
+        events.push_back(InputEvent::keyboard(EventType::KEY_ENTER));
+        return;
+    case 8:
+    case 127:
+        events.push_back(InputEvent::keyboard(EventType::KEY_BACKSPACE));
+        return;
+    default:
+        events.push_back(InputEvent::keyboard(EventType::KEY_PRESS, static_cast<char>(c)));
+        return;
+    }
+}
+
+void InputParser::paste(unsigned char c, std::vector<InputEvent>& events) {
+    if (c == static_cast<unsigned char>(PASTE_END[paste_end_matched])) {
+        if (++paste_end_matched == PASTE_END_LENGTH) {
+            InputEvent event = InputEvent::keyboard(EventType::PASTE);
+            event.text = paste_text; // copy, so paste_text keeps its capacity
+            events.push_back(std::move(event));
+
+            paste_text.clear();
+            paste_end_matched = 0;
+            state = State::GROUND;
+        }
+        return;
+    }
+
+    // Not the end marker after all, so the bytes held back were pasted text. The ESC that
+    // started the match is dropped, pasted text has no business containing escapes.
+    for (int i = 1; i < paste_end_matched; ++i) {
+        append_pasted(static_cast<unsigned char>(PASTE_END[i]));
+    }
+    paste_end_matched = 0;
+
+    if (c == 27) {
+        paste_end_matched = 1; // could be the real marker starting right here
+        return;
+    }
+    append_pasted(c);
+}
+
+void InputParser::append_pasted(unsigned char c) {
+    // Terminals send line breaks as CR, sometimes CRLF. Normalize them all to '\n'.
+    if (c == '\n' && paste_after_cr) {
+        paste_after_cr = false;
+        return;
+    }
+    paste_after_cr = (c == '\r');
+    paste_text += (c == '\r') ? '\n' : static_cast<char>(c);
+}
+
+void InputParser::start_csi() {
+    state = State::CSI;
+    param_count = 0;
+    for (int& p : params) p = 0;
+    prefix = 0;
+    intermediate = 0;
+}
+
+void InputParser::dispatch_csi(unsigned char final_byte, std::vector<InputEvent>& events) {
+    int first = param_count > 0 ? params[0] : 0;
+
+    if (prefix == '<') {
+        if ((final_byte == 'M' || final_byte == 'm') && param_count >= 3) {
+            dispatch_mouse(final_byte == 'm', events);
+        }
+        return;
+    }
+
+    if (prefix == '?') {
+        // DECRPM, the answer to a DECRQM mode query: CSI ? mode ; value $ y
+        if (final_byte == 'y' && intermediate == '$' && param_count >= 2 && first == 2026) {
+            sync_output_report = params[1];
+        }
+        return;
+    }
+
+    if (prefix != 0 || intermediate != 0) return;
+
+    switch (final_byte) {
+    // Modifiers (like CSI 1;5A for Ctrl+Up) are reported as the plain arrow.
+    case 'A': events.push_back(InputEvent::keyboard(EventType::KEY_UP)); return;
+    case 'B': events.push_back(InputEvent::keyboard(EventType::KEY_DOWN)); return;
+    case 'C': events.push_back(InputEvent::keyboard(EventType::KEY_RIGHT)); return;
+    case 'D': events.push_back(InputEvent::keyboard(EventType::KEY_LEFT)); return;
+    case '~':
+        if (first == 200) {
+            state = State::PASTE;
+            paste_text.clear();
+            paste_end_matched = 0;
+            paste_after_cr = false;
+        }
+        return; // Home, End, Delete, F5+ have no event yet
+    default:
+        return;
+    }
+}
+
+void InputParser::dispatch_mouse(bool release, std::vector<InputEvent>& events) {
+    int button = params[0];
+    int x = params[1];
+    int y = params[2];
+
+    if (button & 64) {
+        // Wheel. Bits 2-4 carry modifiers, the low two bits the direction.
+        if ((button & 3) == 0) events.push_back(InputEvent::mouse(EventType::MOUSE_SCROLL_UP, 0, x, y, 1));
+        else if ((button & 3) == 1) events.push_back(InputEvent::mouse(EventType::MOUSE_SCROLL_DOWN, 0, x, y, 1));
+        return;
+    }
+
+    // Motion reports (with or without a button held) must not disturb a pending click,
+    // otherwise any twitch between press and release loses it. The key is the button
+    // being dragged, or 3 when none is held.
+    if (button & 32) {
+        events.push_back(InputEvent::mouse(EventType::MOUSE_MOVE, static_cast<char>(button & 3), x, y));
+        return;
+    }
+
+    if (!release) {
+        pressed_button = button;
+        pressed_x = x;
+        pressed_y = y;
+        return;
+    }
+
+    if (pressed_button != -1 && button == pressed_button && x == pressed_x && y == pressed_y) {
+        events.push_back(InputEvent::mouse(EventType::MOUSE_PRESS, static_cast<char>(button), x, y));
+    }
+    pressed_button = -1;
+}
+
+void InputParser::coalesce(std::vector<InputEvent>& events, size_t first) {
+    auto is_scroll = [](const InputEvent& e) {
+        return e.type == EventType::MOUSE_SCROLL_UP || e.type == EventType::MOUSE_SCROLL_DOWN;
+    };
+
+    size_t out = first;
+    for (size_t i = first; i < events.size(); ++i) {
+        InputEvent e = events[i];
+
+        if (out > first) {
+            InputEvent& prev = events[out - 1];
+
+            if (e.type == EventType::MOUSE_MOVE && prev.type == EventType::MOUSE_MOVE) {
+                prev = e; // only the latest position matters
+                continue;
+            }
+
+            if (is_scroll(e) && is_scroll(prev)) {
+                int net = (prev.type == EventType::MOUSE_SCROLL_UP ? prev.scroll_delta : -prev.scroll_delta)
+                        + (e.type == EventType::MOUSE_SCROLL_UP ? e.scroll_delta : -e.scroll_delta);
+                if (net == 0) {
+                    --out; // up and down cancelled out
+                    continue;
+                }
+                prev.type = net > 0 ? EventType::MOUSE_SCROLL_UP : EventType::MOUSE_SCROLL_DOWN;
+                prev.scroll_delta = net > 0 ? net : -net;
+                prev.mouse_x = e.mouse_x;
+                prev.mouse_y = e.mouse_y;
+                continue;
+            }
+        }
+        events[out++] = e;
+    }
+    events.resize(out);
+}
+
+void InputParser::flush(std::vector<InputEvent>& events) {
+    if (state == State::ESCAPE) {
+        events.push_back(InputEvent::keyboard(EventType::KEY_ESCAPE));
+    }
+    if (pending()) {
+        state = State::GROUND;
+    }
+}
@@ -11,45 +11,132 @@
 
 void List::add(std::shared_ptr<Component> comp) {
     children.push_back(std::move(comp));
+    if (heights_width >= 0) {
+        heights.push_back(children.back()->measure(heights_width) + gap);
+    }
+    adopt(children.back().get());
 }
 
 List& List::set_gap(int g) {
+    if (gap != g) invalidate_heights();
     gap = g;
+    invalidate_layout();
     return *this;
 }
 
 List& List::set_padding(int p) {
     padding = p;
+    invalidate_layout();
     return *this;
 }
 
+List& List::set_virtualized(bool enabled) {
+    virtualized = enabled;
+    invalidate_heights();
+    return *this;
+}
+
+void List::invalidate_height(size_t index) {
+    if (heights_width < 0 || index >= children.size()) return;
+    heights.set(index, children[index]->measure(heights_width) + gap);
+    invalidate_layout();
+}
+
+void List::invalidate_heights() {
+    heights_width = -1;
+    heights.clear();
+    invalidate_layout();
+}
+
+void List::build_heights(int content_w) const {
+    if (heights_width == content_w && heights.size() == children.size()) return;
+
+    std::vector<int> values(children.size());
+    for (size_t i = 0; i < children.size(); ++i) {
+        values[i] = children[i]->measure(content_w) + gap;
+    }
+    heights.assign(values);
+    heights_width = content_w;
+}
+
+// Returns true if any child moved, or the total changed.
+bool List::arrange(int content_w) const {
+    if (tops_width == content_w && tops_generation == get_layout_generation() && tops.size() == children.size() + 1) return false;
+
+    bool moved = tops_width != content_w || tops.size() != children.size() + 1;
+    tops.resize(children.size() + 1);
+    int top = 0;
+    for (size_t i = 0; i < children.size(); ++i) {
+        moved |= tops[i] != top;
+        tops[i] = top;
+        top += children[i]->measure(content_w) + gap;
+    }
+    moved |= tops.back() != top;
+    tops.back() = top;
+    tops_width = content_w;
+    tops_generation = get_layout_generation(); // after measuring, a provider may have bumped it
+    return moved;
+}
+
+int List::content_width(int width) const {
+    int absWidth = width > 2 * padding ? width - 2 * padding : 0;
+    if (scrollbar_enabled) absWidth--;
+    return absWidth;
+}
+
 List& List::set_scrollbar_enabled(bool enabled) {
+    if (scrollbar_enabled != enabled) invalidate_heights();
     scrollbar_enabled = enabled;
+    invalidate_layout();
     return *this;
 }
 
+bool List::child_needs_layout(const Component& child) const {
+    return child.measure(child.last_w) != child.last_h;
+}
+
+void List::refresh_children() {
+    if (!virtualized) {
+        Component::refresh_children();
+        return;
+    }
+    // Rows out of view are not polled, render() refreshes them as they scroll in.
+    for (size_t i = drawn_first; i < drawn_end; ++i) children[i]->refresh();
+}
+
+bool List::layout_moved() const {
+    // A virtualized list only follows the heights of the rows on screen, see invalidate_height().
+    return !virtualized && tops_width >= 0 && arrange(tops_width);
+}
+
 void List::clear() {
+    release_children();
     children.clear();
+    drawn_first = drawn_end = 0;
+    invalidate_heights();
 }
 
 void List::scroll_up(int amount) {
     scroll_offset = std::max(0, scroll_offset - amount);
+    mark_dirty();
 }
 
 void List::scroll_down(int amount) {
     scroll_offset += amount; // Clamping is handled in render()
+    mark_dirty();
 }
 
 int List::get_preferred_height(int width) const {
-    int absWidth = width > 2 * padding ? width - 2 * padding : 0;
-    if (scrollbar_enabled) absWidth--;
+    int absWidth = content_width(width);
 
     int total = 0;
-    if (!children.empty()) {
-        for (const auto& child : children) {
-            total += child->get_preferred_height(absWidth);
-        }
-        total += gap * (children.size() - 1);
+    if (virtualized && !children.empty()) {
+        build_heights(absWidth);
+        total = (int)heights.total() - gap;
+    }
+    else if (!children.empty()) {
+        arrange(absWidth);
+        total = tops.back() - gap;
     }
     total += 2 * padding;
     return total;
@@ -57,6 +144,8 @@ int List::get_preferred_height(int width) const {
 
 void List::render(ScreenBuffer& buffer, int x, int y, int w, int h) {
     Component::render(buffer, x, y, w, h);
+    const size_t was_first = drawn_first, was_end = drawn_end;
+    drawn_first = drawn_end = 0;
     if (w <= 0 || h <= 0) return;
 
     int innerX = x + padding;
@@ -70,11 +159,13 @@ void List::render(ScreenBuffer& buffer, int x, int y, int w, int h) {
     if (content_w <= 0 || innerH <= 0) return;
 
     int total_content_height = 0;
-    if (!children.empty()) {
-        for (const auto& child : children) {
-            total_content_height += child->get_preferred_height(content_w);
-        }
-        total_content_height += gap * (children.size() - 1);
+    if (virtualized && !children.empty()) {
+        build_heights(content_w);
+        total_content_height = (int)heights.total() - gap;
+    }
+    else if (!children.empty()) {
+        arrange(content_w);
+        total_content_height = tops.back() - gap;
     }
 
     bool is_scrollable = total_content_height > innerH;
@@ -88,15 +179,45 @@ void List::render(ScreenBuffer& buffer, int x, int y, int w, int h) {
         const_cast<List*>(this)->scroll_offset = 0;
     }
 
-    int currentY = innerY - scroll_offset;
-    for (const auto& child : children) {
-        int child_h = child->get_preferred_height(content_w);
-        if (currentY + child_h > y && currentY < y + h) {
-            child->render(buffer, innerX, currentY, content_w, child_h);
+    // Children cut off at the top or bottom must not draw outside the list.
+    const RowClip outer = buffer.clip_rows(innerY, innerY + innerH);
+    if (virtualized) {
+        // Jump straight to the child holding the first visible row, then render until the
+        // bottom edge. Children on screen are measured anyway, so their cached heights are
+        // corrected for free if they changed.
+        size_t first = heights.find(scroll_offset);
+        int currentY = innerY + (int)heights.prefix(first) - scroll_offset;
+        size_t i = first;
+        for (; i < children.size() && currentY < innerY + innerH; ++i) {
+            // refresh_children() only reached last frame's rows.
+            if (i < was_first || i >= was_end) children[i]->refresh();
+            int child_h = children[i]->measure(content_w);
+            if (child_h + gap != heights.get(i)) heights.set(i, child_h + gap);
+            children[i]->render(buffer, innerX, currentY, content_w, child_h);
+            currentY += child_h + gap;
+        }
+        drawn_first = first;
+        drawn_end = i;
+    }
+    else if (!children.empty()) {
+        // The arrangement is in content coordinates, so scrolling only moves where it is painted.
+        const int origin = innerY - scroll_offset;
+        const size_t count = children.size();
+        size_t first = std::upper_bound(tops.begin(), tops.begin() + count, y - origin) - tops.begin();
+        if (first > 0) first--;
+        size_t i = first;
+        for (; i < count; ++i) {
+            int currentY = origin + tops[i];
+            if (currentY >= y + h) break;
+            int child_h = tops[i + 1] - tops[i] - gap;
+            if (currentY + child_h > y) {
+                children[i]->render(buffer, innerX, currentY, content_w, child_h);
+            }
         }
-        currentY += child_h + gap;
-        if (currentY >= y + h + scroll_offset) break;
+        drawn_first = first;
+        drawn_end = i;
     }
+    buffer.restore_clip(outer);
 
     if (scrollbar_enabled && is_scrollable) {
         int scrollbarX = innerX + content_w;
@@ -0,0 +1,389 @@
+#include "core/output_encoder.hpp"
+#include "core/ansi.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+    enum : std::uint16_t {
+        BOLD = 1 << 1, DIM = 1 << 2, ITALIC = 1 << 3, UNDERLINE = 1 << 4,
+        BLINK = 1 << 5, RAPID_BLINK = 1 << 6, INVERSE = 1 << 7, HIDDEN = 1 << 8, STRIKE = 1 << 9
+    };
+
+    int digits(int value) {
+        int n = 1;
+        while (value >= 10) { value /= 10; ++n; }
+        return n;
+    }
+
+    // Length of "\033[<n><final>", where CUF/CUB/CUD/CHA with n == 1 can drop the number.
+    int csi_len(int n) {
+        return n == 1 ? 3 : 3 + digits(n);
+    }
+}
+
+OutputEncoder::OutputEncoder(size_t initial_capacity) {
+    out.reserve(initial_capacity);
+}
+
+void OutputEncoder::begin_frame() {
+    out.clear();
+    if (synchronized) out += ansi::BEGIN_SYNCHRONIZED_UPDATE;
+    frame_start = out.size();
+    cursor_x = cursor_y = -1;
+}
+
+void OutputEncoder::append_raw(std::string_view bytes) {
+    out += bytes;
+    cursor_x = cursor_y = -1;
+}
+
+void OutputEncoder::encode_diff(const ScreenBuffer& current, const ScreenBuffer& previous) {
+    const int screen_w = current.width();
+
+    // Outside their dirty spans both buffers are blank, so only rows (and columns) that
+    // either frame drew on can differ. Untouched rows are skipped without looking at them.
+    int rows_begin = std::min(current.dirty_rows_begin(), previous.dirty_rows_begin());
+    int rows_end = std::max(current.dirty_rows_end(), previous.dirty_rows_end());
+
+    for (int y = rows_begin; y < rows_end; ++y) {
+        DirtySpan span = current.dirty_span(y).merged(previous.dirty_span(y));
+        if (span.empty()) continue;
+
+        ConstCellSpan now = current.row(y);
+        ConstCellSpan before = previous.row(y);
+        if (std::memcmp(now.data + span.begin, before.data + span.begin,
+                        (span.end - span.begin) * sizeof(Cell)) == 0) {
+            continue;
+        }
+
+        int written_until = 0; // columns before this were covered by a wide glyph written this row
+        for (int x = span.begin; x < span.end; ++x) {
+            if (now[x] == before[x] || x < written_until) continue;
+
+            Cell cell = now[x];
+            int width = glyph::width(cell.glyph);
+            if (width == 0) {
+                // Only the second half changed (its style, say). Write the whole glyph again.
+                if (x > 0 && glyph::width(now[x - 1].glyph) == 2) {
+                    cell = now[--x];
+                    width = 2;
+                }
+                else {
+                    cell.glyph = glyph::SPACE; // its first half was drawn over
+                    width = 1;
+                }
+            }
+            else if (width == 2 && (x + 1 >= screen_w || now[x + 1].glyph != glyph::CONTINUATION)) {
+                cell.glyph = glyph::SPACE; // its second half was drawn over, or it hangs off the edge
+                width = 1;
+            }
+
+            // A short gap of unchanged ASCII cells in the current style is cheaper to
+            // write again than to jump over.
+            if (cursor_y == y && cursor_x < x && x - cursor_x < 4) {
+                bool can_fill = true;
+                for (int gx = cursor_x; gx < x; ++gx) {
+                    Glyph g = now[gx].glyph;
+                    if (now[gx].style != style || g < 0x20 || g >= 0x7F) { can_fill = false; break; }
+                }
+                if (can_fill) {
+                    for (int gx = cursor_x; gx < x; ++gx) out += static_cast<char>(now[gx].glyph);
+                    cursor_x = x;
+                }
+            }
+
+            move_to(x, y);
+            write_cell(cell, width, screen_w);
+            written_until = x + width;
+        }
+    }
+}
+
+void OutputEncoder::end_frame() {
+    if (out.size() == frame_start) {
+        out.clear(); // nothing changed, do not send an empty synchronized update either
+        return;
+    }
+    if (!style_known || style != StyleRegistry::RESET_ID) {
+        out += ansi::RESET;
+        style = StyleRegistry::RESET_ID;
+        style_known = true;
+    }
+    out += ansi::HIDE_CURSOR;
+    if (frame_start > 0) out += ansi::END_SYNCHRONIZED_UPDATE; // begin_frame() opened one
+}
+
+void OutputEncoder::write_cell(const Cell& cell, int width, int screen_w) {
+    set_style(cell.style);
+    glyph::append_utf8(out, cell.glyph);
+    cursor_x += width;
+    // Writing the last column leaves the terminal in its "pending wrap" state, where
+    // terminals disagree about where the cursor is. Force an absolute move next time.
+    if (cursor_x >= screen_w) cursor_x = cursor_y = -1;
+}
+
+void OutputEncoder::move_to(int x, int y) {
+    if (cursor_x == x && cursor_y == y) return;
+
+    // Absolute CUP always works, everything else is only a candidate if it is shorter.
+    int best = (x == 0) ? 3 + digits(y + 1) : 4 + digits(y + 1) + digits(x + 1);
+    enum { ABSOLUTE, SAME_ROW, NEXT_LINE, DOWN } how = ABSOLUTE;
+
+    if (cursor_y == y) {
+        int cost = (x == 0) ? 1
+            : (x > cursor_x) ? csi_len(x - cursor_x)
+            : std::min(csi_len(cursor_x - x), csi_len(x + 1));
+        if (cost < best) { best = cost; how = SAME_ROW; }
+    }
+    else if (cursor_y >= 0 && y > cursor_y) {
+        if (x == 0 && y == cursor_y + 1) {
+            best = 2;
+            how = NEXT_LINE;
+        }
+        else {
+            int horizontal = (x == cursor_x) ? 0
+                : (x == 0) ? 1
+                : (x > cursor_x) ? csi_len(x - cursor_x)
+                : std::min(csi_len(cursor_x - x), csi_len(x + 1));
+            int cost = csi_len(y - cursor_y) + horizontal;
+            if (cost < best) { best = cost; how = DOWN; }
+        }
+    }
+
+    auto horizontal_move = [&]() {
+        if (x == cursor_x) return;
+        if (x == 0) { out += '\r'; return; }
+        auto csi = [&](int n, char final_byte) {
+            out += "\033[";
+            if (n != 1) append_int(n);
+            out += final_byte;
+        };
+        if (x > cursor_x) csi(x - cursor_x, 'C');
+        else if (csi_len(cursor_x - x) <= csi_len(x + 1)) csi(cursor_x - x, 'D');
+        else csi(x + 1, 'G');
+    };
+
+    switch (how) {
+    case ABSOLUTE:
+        out += "\033[";
+        append_int(y + 1);
+        if (x != 0) {
+            out += ';';
+            append_int(x + 1);
+        }
+        out += 'H';
+        break;
+    case SAME_ROW:
+        horizontal_move();
+        break;
+    case NEXT_LINE:
+        out += "\r\n";
+        break;
+    case DOWN:
+        out += "\033[";
+        if (y - cursor_y != 1) append_int(y - cursor_y);
+        out += 'B';
+        horizontal_move();
+        break;
+    }
+
+    cursor_x = x;
+    cursor_y = y;
+}
+
+void OutputEncoder::set_style(StyleId id) {
+    if (style_known && id == style) return;
+
+    const SgrState from = style_known ? sgr_for(style) : SgrState{};
+    const SgrState& to = sgr_for(id);
+
+    if (to.opaque || from.opaque) {
+        // We cant reason about these, so start from a clean slate.
+        out += ansi::RESET;
+        if (to.opaque) {
+            out += StyleRegistry::get(id);
+        }
+        else if (to.flags || to.fg.kind != SgrState::COLOR_DEFAULT || to.bg.kind != SgrState::COLOR_DEFAULT) {
+            out += "\033[";
+            first_param = true;
+            append_sgr_params(SgrState{}, to);
+            out += 'm';
+        }
+    }
+    else {
+        out += "\033[";
+        first_param = true;
+        if (!style_known) append_param(0); // whatever the terminal had before us
+        append_sgr_params(from, to);
+        out += 'm';
+    }
+
+    style = id;
+    style_known = true;
+}
+
+void OutputEncoder::append_sgr_params(const SgrState& from, const SgrState& to) {
+    std::uint16_t turned_off = from.flags & ~to.flags;
+
+    // Switching several attributes off one by one is longer than a reset and a rebuild.
+    int off_count = 0;
+    for (std::uint16_t bits = turned_off; bits; bits &= bits - 1) off_count++;
+    if (off_count >= 2) {
+        append_param(0);
+        append_sgr_params(SgrState{}, to);
+        return;
+    }
+
+    std::uint16_t turned_on = to.flags & ~from.flags;
+    if (turned_off & (BOLD | DIM)) {
+        append_param(22); // turns off both, so put back whichever one stays
+        turned_on |= to.flags & (BOLD | DIM);
+    }
+    if (turned_off & ITALIC) append_param(23);
+    if (turned_off & UNDERLINE) append_param(24);
+    if (turned_off & (BLINK | RAPID_BLINK)) {
+        append_param(25);
+        turned_on |= to.flags & (BLINK | RAPID_BLINK);
+    }
+    if (turned_off & INVERSE) append_param(27);
+    if (turned_off & HIDDEN) append_param(28);
+    if (turned_off & STRIKE) append_param(29);
+
+    for (int n = 1; n <= 9; ++n) {
+        if (turned_on & (1 << n)) append_param(n);
+    }
+
+    if (from.fg != to.fg) append_color(30, to.fg);
+    if (from.bg != to.bg) append_color(40, to.bg);
+
+    // Both states were identical apart from things that cancel out, still write a valid sequence.
+    if (first_param) append_param(0);
+}
+
+void OutputEncoder::append_color(int base, const SgrState::Color& color) {
+    switch (color.kind) {
+    case SgrState::COLOR_DEFAULT:
+        append_param(base + 9);
+        break;
+    case SgrState::COLOR_BASIC:
+        append_param(static_cast<int>(color.value));
+        break;
+    case SgrState::COLOR_256:
+        append_param(base + 8);
+        append_param(5);
+        append_param(static_cast<int>(color.value));
+        break;
+    case SgrState::COLOR_RGB:
+        append_param(base + 8);
+        append_param(2);
+        append_param(static_cast<int>((color.value >> 16) & 0xFF));
+        append_param(static_cast<int>((color.value >> 8) & 0xFF));
+        append_param(static_cast<int>(color.value & 0xFF));
+        break;
+    }
+}
+
+void OutputEncoder::append_param(int value) {
+    if (!first_param) out += ';';
+    append_int(value);
+    first_param = false;
+}
+
+void OutputEncoder::append_int(int value) {
+    char digits_buf[12];
+    int n = 0;
+    do {
+        digits_buf[n++] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    } while (value > 0);
+    while (n > 0) out += digits_buf[--n];
+}
+
+const OutputEncoder::SgrState& OutputEncoder::sgr_for(StyleId id) {
+    if (id >= sgr_cache.size()) {
+        size_t size = std::max<size_t>(id + 1, StyleRegistry::size());
+        sgr_cache.resize(size);
+        sgr_cached.resize(size, false);
+    }
+    if (!sgr_cached[id]) {
+        sgr_cache[id] = parse_sgr(StyleRegistry::get(id));
+        sgr_cached[id] = true;
+    }
+    return sgr_cache[id];
+}
+
+OutputEncoder::SgrState OutputEncoder::parse_sgr(std::string_view s) {
+    SgrState state;
+    size_t i = 0;
+
+    while (i < s.size()) {
+        if (s[i] != '\033' || i + 1 >= s.size() || s[i + 1] != '[') {
+            state.opaque = true;
+            return state;
+        }
+        i += 2;
+
+        int params[16];
+        int count = 0;
+        int value = 0;
+        bool any = false;
+        for (; i < s.size() && ((s[i] >= '0' && s[i] <= '9') || s[i] == ';'); ++i) {
+            if (s[i] == ';') {
+                if (count < 16) params[count++] = value;
+                value = 0;
+                any = true;
+            }
+            else {
+                value = value * 10 + (s[i] - '0');
+                any = true;
+            }
+        }
+        if (any && count < 16) params[count++] = value;
+        if (i >= s.size() || s[i] != 'm') {
+            state.opaque = true;
+            return state;
+        }
+        ++i;
+
+        if (count == 0) state = SgrState{};
+
+        auto read_color = [&](int& k, SgrState::Color& color) {
+            if (k + 2 < count && params[k + 1] == 5) {
+                color = { SgrState::COLOR_256, static_cast<std::uint32_t>(params[k + 2]) };
+                k += 2;
+                return true;
+            }
+            if (k + 4 < count && params[k + 1] == 2) {
+                color = { SgrState::COLOR_RGB, static_cast<std::uint32_t>(
+                    (params[k + 2] & 0xFF) << 16 | (params[k + 3] & 0xFF) << 8 | (params[k + 4] & 0xFF)) };
+                k += 4;
+                return true;
+            }
+            return false;
+        };
+
+        for (int k = 0; k < count; ++k) {
+            int p = params[k];
+            if (p == 0) state = SgrState{};
+            else if (p >= 1 && p <= 9) state.flags |= static_cast<std::uint16_t>(1 << p);
+            else if (p == 22) state.flags &= ~(BOLD | DIM);
+            else if (p == 23) state.flags &= ~ITALIC;
+            else if (p == 24) state.flags &= ~UNDERLINE;
+            else if (p == 25) state.flags &= ~(BLINK | RAPID_BLINK);
+            else if (p == 27) state.flags &= ~INVERSE;
+            else if (p == 28) state.flags &= ~HIDDEN;
+            else if (p == 29) state.flags &= ~STRIKE;
+            else if ((p >= 30 && p <= 37) || (p >= 90 && p <= 97)) state.fg = { SgrState::COLOR_BASIC, static_cast<std::uint32_t>(p) };
+            else if ((p >= 40 && p <= 47) || (p >= 100 && p <= 107)) state.bg = { SgrState::COLOR_BASIC, static_cast<std::uint32_t>(p) };
+            else if (p == 39) state.fg = {};
+            else if (p == 49) state.bg = {};
+            else if (p == 38) { if (!read_color(k, state.fg)) { state.opaque = true; return state; } }
+            else if (p == 48) { if (!read_color(k, state.bg)) { state.opaque = true; return state; } }
+            else {
+                state.opaque = true;
+                return state;
+            }
+        }
+    }
+    return state;
+}
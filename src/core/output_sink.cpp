@@ -0,0 +1,111 @@
+#include "core/output_sink.hpp"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <cerrno>
+#endif
+
+// The sink that currently owns stdout, so terminal::shutdown() can hand stdout back even
+// when it runs from a signal handler that never reaches the sink's destructor.
+static OutputSink* active_sink = nullptr;
+
+OutputSink::OutputSink() {
+    active_sink = this;
+    // Console writes on Windows can not be made non-blocking, write() just loops until done.
+#ifndef _WIN32
+    original_flags = fcntl(STDOUT_FILENO, F_GETFL);
+    if (original_flags != -1) {
+        fcntl(STDOUT_FILENO, F_SETFL, original_flags | O_NONBLOCK);
+    }
+#endif
+}
+
+OutputSink::~OutputSink() {
+    close();
+}
+
+void OutputSink::close_active() {
+    if (active_sink) active_sink->close();
+}
+
+size_t OutputSink::write_some(const char* data, size_t size) {
+    size_t done = 0;
+#ifdef _WIN32
+    HANDLE out = GetStdHandle(STD_OUTPUT_HANDLE);
+    while (done < size) {
+        DWORD written = 0;
+        if (!WriteFile(out, data + done, static_cast<DWORD>(size - done), &written, nullptr) || written == 0) {
+            break;
+        }
+        done += written;
+    }
+#else
+    while (done < size) {
+        ssize_t n = ::write(STDOUT_FILENO, data + done, size - done);
+        if (n > 0) {
+            done += static_cast<size_t>(n);
+        }
+        else if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        else {
+            break; // EAGAIN means the terminal is full, anything else we can not fix here
+        }
+    }
+#endif
+    return done;
+}
+
+bool OutputSink::flush() {
+    if (!busy()) return true;
+
+    sent += write_some(pending.data() + sent, pending.size() - sent);
+    if (!busy()) {
+        // Keep the capacity, a congested link tends to stay congested.
+        pending.clear();
+        sent = 0;
+        return true;
+    }
+    return false;
+}
+
+bool OutputSink::write(std::string_view bytes) {
+    if (bytes.empty()) return flush();
+
+    // Common case: nothing queued, write straight from the caller's buffer without copying.
+    if (!busy()) {
+        size_t done = write_some(bytes.data(), bytes.size());
+        if (done == bytes.size()) return true;
+        pending.assign(bytes.data() + done, bytes.size() - done);
+        sent = 0;
+        return false;
+    }
+
+    pending.append(bytes.data(), bytes.size());
+    return flush();
+}
+
+void OutputSink::close() {
+    if (closed) return;
+
+#ifndef _WIN32
+    while (!flush()) {
+        pollfd fd = { STDOUT_FILENO, POLLOUT, 0 };
+        if (poll(&fd, 1, -1) < 0 && errno != EINTR) break;
+        if (fd.revents & (POLLERR | POLLHUP | POLLNVAL)) break;
+    }
+    if (original_flags != -1) {
+        fcntl(STDOUT_FILENO, F_SETFL, original_flags);
+    }
+#else
+    flush();
+#endif
+    pending.clear();
+    sent = 0;
+    closed = true;
+    if (active_sink == this) active_sink = nullptr;
+}
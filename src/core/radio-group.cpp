@@ -10,10 +10,12 @@ RadioGroup::RadioGroup(const std::vector<std::string>& options, int* target_idx,
     for (const auto& btn : radio_buttons) {
         internal_list.add(btn);
     }
+    adopt(&internal_list);
 
     if (!radio_buttons.empty()) {
         active_button_idx = *target_index;
     }
+    set_polling(target_index != nullptr);
 }
 bool RadioGroup::handle_mouse_press(int x, int y) {
     for (size_t i = 0; i < radio_buttons.size(); ++i) {
@@ -28,26 +30,34 @@ bool RadioGroup::handle_mouse_press(int x, int y) {
 void RadioGroup::focus_next() {
     if (radio_buttons.empty()) return;
     active_button_idx = (active_button_idx + 1) % radio_buttons.size();
+    mark_dirty();
 }
 
 void RadioGroup::focus_previous() {
     if (radio_buttons.empty()) return;
     active_button_idx = (active_button_idx - 1 + radio_buttons.size()) % radio_buttons.size();
+    mark_dirty();
 }
 
 void RadioGroup::select_active() {
     if (target_index) {
         *target_index = active_button_idx;
+        mark_dirty();
     }
 }
 
+bool RadioGroup::poll() {
+    return target_index && *target_index != drawn_target;
+}
+
 int RadioGroup::get_preferred_height(int width) const {
-    return internal_list.get_preferred_height(width);
+    return internal_list.measure(width);
 }
 
 void RadioGroup::render(ScreenBuffer& buffer, int x, int y, int w, int h) {
     Component::render(buffer, x, y, w, h);
-    
+    drawn_target = target_index ? *target_index : -1;
+
     for (size_t i = 0; i < radio_buttons.size(); ++i) {
         radio_buttons[i]->set_active(i == active_button_idx);
         radio_buttons[i]->set_selected(i == *target_index);
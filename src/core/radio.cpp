@@ -1,18 +1,20 @@
 #include "core/radio.hpp"
+#include <algorithm>
 
 int Radio::get_preferred_height(int width) const {
     int label_width = (width > 4) ? width - 4 : 0;
-    Text temp_renderer(label, TextStyle());
-    return temp_renderer.get_preferred_height(label_width);
+    return label_text.measure(label_width);
 }
 
 void Radio::render(ScreenBuffer& buffer, int x, int y, int w, int h) {
     Component::render(buffer, x, y, w, h);
 
     const TextStyle& current_style = is_active ? style.active : style.normal;
-    std::string marker = is_selected ? "(o) " : "( ) ";
-    std::string full_text = marker + label;
 
-    Text text_renderer(full_text, current_style);
-    text_renderer.render(buffer, x, y, w, h);
+    // The marker takes the first four columns, the label wraps in the rest.
+    marker.set_text(is_selected ? "(o) " : "( ) ").set_style(current_style);
+    marker.render(buffer, x, y, std::min(w, 4), h);
+
+    label_text.set_style(current_style);
+    label_text.render(buffer, x + 4, y, w - 4, h);
 }
@@ -12,11 +12,12 @@
 #include "core/runtime.hpp"
 #include "core/ansi.hpp"
 #include "core/screen_buffer.hpp"
+#include "core/output_encoder.hpp"
+#include "core/output_sink.hpp"
 #include "core/event.hpp"
 #include "core/terminal.hpp"
-#include <iostream>
-#include <thread>
 #include <chrono>
+#include <iostream>
 
 // VIBE CODE STARTS HERE
 
@@ -149,26 +150,80 @@ namespace kontra
         showCursor();
     }
 
-    void run(std::shared_ptr<Screen> screen, std::function<void(const InputEvent &)> onInput)
+    void invalidate()
+    {
+        terminal::wake();
+    }
+
+    void run(std::shared_ptr<Screen> screen, std::function<void(const InputEvent &)> onInput, FrameScheduler scheduler)
     {
         terminal::initialize();
 
-        auto [w, h] = ansi::get_terminal_size();
-        ScreenBuffer current_buffer(w, h);
-        ScreenBuffer previous_buffer(w, h);
-        std::cout << ansi::CLEAR_SCREEN << std::flush;
+        auto [w, h] = terminal::size();
+        DoubleBuffer frames(w, h);
+        ScreenBuffer canvas(0, 0); // the persistent frame of a retained Screen
+        OutputEncoder encoder;
+        OutputSink sink;
+        bool clear_pending = true;
+        bool first_frame = true;
+
+        // Dragging a window edge sends a burst of SIGWINCHs. Instead of clearing and redrawing
+        // at every intermediate size, wait until the size has been stable for this long.
+        using clock = FrameScheduler::Clock;
+        constexpr auto resize_settle = std::chrono::milliseconds(50);
+        bool resize_pending = false;
+        clock::time_point resize_settled_at;
 
         std::vector<InputEvent> events;
+        scheduler.request_frame();
 
         while (true)
         {
+            int timeout_ms = scheduler.wait_timeout_ms(clock::now());
+            if (resize_pending)
+            {
+                auto left = std::chrono::duration_cast<std::chrono::milliseconds>(resize_settled_at - clock::now()).count();
+                timeout_ms = left > 0 ? (int)left : 0;
+            }
+
+            // While the terminal is still chewing on the last frame there is no point in
+            // waking up for the deadline, the next frame has to wait for stdout anyway.
+            if (sink.busy() && !resize_pending)
+            {
+                timeout_ms = -1;
+            }
+
+            // Nothing to do until something happens, so sleep in the kernel instead of spinning.
+            terminal::WakeReasons woke = terminal::wait(timeout_ms, sink.busy());
+            if (woke.output)
+            {
+                sink.flush();
+            }
+            if (woke.resize)
+            {
+                auto [term_w, term_h] = terminal::size();
+                if (term_w != frames.width() || term_h != frames.height())
+                {
+                    resize_pending = true;
+                    resize_settled_at = clock::now() + resize_settle;
+                }
+            }
+            if (woke.wakeup)
+            {
+                scheduler.request_frame();
+            }
+
             events.clear();
-            terminal::read_input_events(events);
+            if (woke.input)
+            {
+                terminal::read_input_events(events);
+            }
 
             for (const auto &event : events)
             {
                 if (event.type == EventType::KEY_PRESS && event.key == 17)
                 {
+                    sink.close();
                     terminal::shutdown();
                     return;
                 }
@@ -176,42 +231,89 @@ namespace kontra
                 {
                     onInput(event);
                 }
+                scheduler.request_frame();
+            }
+
+            if (resize_pending)
+            {
+                if (clock::now() < resize_settled_at)
+                {
+                    continue;
+                }
+                resize_pending = false;
+                scheduler.request_frame();
+            }
+
+            // Do not queue frames behind a congested link. The request stays pending and the
+            // state as of when stdout drains is diffed against the last frame that was sent,
+            // so every frame skipped here is merged into that one.
+            clock::time_point now = clock::now();
+            if (sink.busy() || !scheduler.frame_due(now))
+            {
+                continue;
             }
+            scheduler.begin_frame(now);
 
-            auto [term_w, term_h] = ansi::get_terminal_size();
-            if (term_w != current_buffer.width() || term_h != current_buffer.height())
+            SynchronizedOutput sync_mode = scheduler.get_synchronized_output();
+            encoder.set_synchronized(sync_mode == SynchronizedOutput::ALWAYS ||
+                (sync_mode == SynchronizedOutput::AUTO && terminal::synchronized_output_supported()));
+            encoder.begin_frame();
+            auto [term_w, term_h] = terminal::size();
+            if (term_w != frames.width() || term_h != frames.height())
+            {
+                frames.resize(term_w, term_h);
+                clear_pending = true;
+            }
+            if (clear_pending)
             {
-                current_buffer.resize(term_w, term_h);
-                previous_buffer.resize(term_w, term_h);
-                std::cout << ansi::CLEAR_SCREEN;
+                encoder.append_raw(ansi::CLEAR_SCREEN);
+                clear_pending = false;
+            }
+            if (first_frame)
+            {
+#ifndef _WIN32
+                // The answer arrives as input some time later; until then frames go out unwrapped.
+                if (scheduler.get_synchronized_output() == SynchronizedOutput::AUTO)
+                {
+                    encoder.append_raw(ansi::QUERY_SYNCHRONIZED_UPDATE);
+                }
+#endif
+                first_frame = false;
             }
-            current_buffer.clear();
-            screen->render(current_buffer, 0, 0, current_buffer.width(), current_buffer.height());
-            std::string out_str;
-            std::string last_style = " ";
-            for (int y_idx = 0; y_idx < current_buffer.height(); ++y_idx)
+            ScreenBuffer &current_buffer = frames.back();
+            bool changed = true;
+            if (screen->is_retained())
             {
-                for (int x_idx = 0; x_idx < current_buffer.width(); ++x_idx)
+                // The canvas keeps the last frame, so only what changed gets rendered into it.
+                // A resize blanked both frames, the canvas is redrawn in full then as well.
+                if (canvas.width() != current_buffer.width() || canvas.height() != current_buffer.height())
+                {
+                    canvas.resize(current_buffer.width(), current_buffer.height());
+                }
+                changed = screen->update(canvas);
+                if (changed)
                 {
-                    if (current_buffer.get_cell(x_idx, y_idx) != previous_buffer.get_cell(x_idx, y_idx))
-                    {
-                        out_str += "\033[" + std::to_string(y_idx + 1) + ";" + std::to_string(x_idx + 1) + "H";
-                        const auto &cell = current_buffer.get_cell(x_idx, y_idx);
-                        if (cell.style != last_style)
-                        {
-                            out_str += cell.style;
-                            last_style = cell.style;
-                        }
-                        out_str += cell.character;
-                    }
+                    current_buffer.copy_drawn(canvas);
                 }
             }
-            out_str += ansi::RESET;
-            out_str += ansi::HIDE_CURSOR;
-            std::cout << out_str << std::flush;
-            previous_buffer = current_buffer;
+            else
+            {
+                screen->render(current_buffer, 0, 0, current_buffer.width(), current_buffer.height());
+            }
 
-            std::this_thread::sleep_for(std::chrono::milliseconds(16));
+            if (changed)
+            {
+                encoder.encode_diff(current_buffer, frames.front());
+            }
+            encoder.end_frame();
+            if (!encoder.empty())
+            {
+                sink.write(encoder.bytes());
+            }
+            if (changed)
+            {
+                frames.present();
+            }
         }
     }
 }
@@ -5,8 +5,29 @@
 #include <io.h>
 #include <fcntl.h>
 #endif
+Screen& Screen::set_retained(bool enabled) {
+	retained = enabled;
+	mark_dirty();
+	return *this;
+}
+
+bool Screen::update(ScreenBuffer& canvas) {
+	++Component::frame_epoch;
+	refresh();
+	if (is_dirty() || canvas.width() != last_w || canvas.height() != last_h) {
+		canvas.clear();
+		render(canvas, 0, 0, canvas.width(), canvas.height());
+		settle();
+		return true;
+	}
+	return repaint(canvas);
+}
+
 void Screen::render(ScreenBuffer& buffer, int x, int y, int w, int h) {
 	Component::render(buffer, x, y, w, h);
+	++Component::frame_epoch;
+	// Text providers and bound variables first, so everything below lays out with fresh sizes.
+	refresh();
 #ifdef _WIN32
 	SetConsoleOutputCP(CP_UTF8);
 #endif
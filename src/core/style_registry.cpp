@@ -0,0 +1,43 @@
+#include "core/style_registry.hpp"
+#include "core/ansi.hpp"
+#include <deque>
+#include <unordered_map>
+
+namespace {
+    // Styles live in a deque so the string_view keys never dangle when it grows.
+    struct Registry {
+        std::deque<std::string> styles;
+        std::unordered_map<std::string_view, StyleId> ids;
+
+        Registry() {
+            add(ansi::RESET);
+        }
+
+        StyleId add(std::string_view style) {
+            StyleId id = static_cast<StyleId>(styles.size());
+            const std::string& stored = styles.emplace_back(style);
+            ids.emplace(stored, id);
+            return id;
+        }
+    };
+
+    Registry& registry() {
+        static Registry instance;
+        return instance;
+    }
+}
+
+StyleId StyleRegistry::intern(std::string_view style) {
+    auto& reg = registry();
+    auto it = reg.ids.find(style);
+    if (it != reg.ids.end()) return it->second;
+    return reg.add(style);
+}
+
+const std::string& StyleRegistry::get(StyleId id) {
+    return registry().styles[id];
+}
+
+std::size_t StyleRegistry::size() {
+    return registry().styles.size();
+}
@@ -0,0 +1,318 @@
+#include "core/table.hpp"
+#include "core/ansi.hpp"
+#include "core/unicode.hpp"
+#include <algorithm>
+
+#ifdef _WIN32
+#undef min
+#undef max
+#endif
+
+namespace {
+    // The source behind the function constructor.
+    class FunctionTableSource : public TableSource {
+    public:
+        FunctionTableSource(std::function<size_t()> count, std::function<std::string(size_t, size_t)> text)
+            : count(std::move(count)), text(std::move(text)) {}
+
+        size_t row_count() const override { return count(); }
+        std::string_view cell(size_t row, size_t column) const override {
+            scratch = text(row, column);
+            return scratch;
+        }
+
+    private:
+        std::function<size_t()> count;
+        std::function<std::string(size_t, size_t)> text;
+        mutable std::string scratch;
+    };
+
+    // Same styles a Text with this TextStyle would draw with: the whole style for glyphs,
+    // and just the background for the empty cells around them.
+    void intern_style(const TextStyle& style, StyleId& full, StyleId& background) {
+        std::string text_style = style.color + style.background_color;
+        if (style.bold) text_style += ansi::BOLD;
+        if (style.underline) text_style += ansi::UNDERLINE;
+        if (style.italic) text_style += ansi::ITALIC;
+
+        full = StyleRegistry::intern(text_style);
+        background = style.background_color.empty()
+            ? StyleRegistry::RESET_ID
+            : StyleRegistry::intern(style.background_color);
+    }
+
+    // Draws one cell, `width` columns wide of which the first `visible` are on screen. Text
+    // that does not fit is cut short with an ellipsis.
+    void draw_cell(ScreenBuffer& buffer, int x, int y, int width, int visible, std::string_view text, ColumnAlignment alignment, StyleId style) {
+        const int text_w = unicode::display_width(text);
+        if (text_w > width) {
+            const int last = width - 1;
+            unicode::draw_text(buffer.span(x, y, std::min(visible, last)), text, style);
+            if (last < visible) {
+                static const Glyph ellipsis = glyph::from_utf8(u8"…");
+                CellSpan tail = buffer.span(x + last, y, 1);
+                if (tail.size > 0) tail[0] = { ellipsis, style };
+            }
+            return;
+        }
+
+        int column = 0;
+        if (alignment == ColumnAlignment::Right) column = width - text_w;
+        else if (alignment == ColumnAlignment::Center) column = (width - text_w) / 2;
+        unicode::draw_text(buffer.span(x, y, visible), text, style, column);
+    }
+}
+
+ColumnarTableSource::ColumnarTableSource(size_t columns)
+    : columns(columns) {}
+
+void ColumnarTableSource::append_row(std::initializer_list<std::string_view> cells) {
+    size_t i = 0;
+    for (Column& column : columns) {
+        if (i < cells.size()) column.bytes.append(cells.begin()[i]);
+        column.ends.push_back(column.bytes.size());
+        i++;
+    }
+    rows++;
+}
+
+void ColumnarTableSource::append_row(const std::vector<std::string>& cells) {
+    size_t i = 0;
+    for (Column& column : columns) {
+        if (i < cells.size()) column.bytes.append(cells[i]);
+        column.ends.push_back(column.bytes.size());
+        i++;
+    }
+    rows++;
+}
+
+void ColumnarTableSource::reserve(size_t rows, size_t cell_bytes) {
+    for (Column& column : columns) {
+        column.bytes.reserve(rows * cell_bytes);
+        column.ends.reserve(rows);
+    }
+}
+
+void ColumnarTableSource::clear() {
+    for (Column& column : columns) {
+        column.bytes.clear();
+        column.ends.clear();
+    }
+    rows = 0;
+    edit_generation++;
+}
+
+std::string_view ColumnarTableSource::cell(size_t row, size_t column) const {
+    if (row >= rows || column >= columns.size()) return {};
+    const Column& c = columns[column];
+    const size_t begin = row == 0 ? 0 : c.ends[row - 1];
+    return std::string_view(c.bytes.data() + begin, c.ends[row] - begin);
+}
+
+Table::Table(std::vector<TableColumn> columns, std::shared_ptr<TableSource> source)
+    : source(std::move(source)), columns(std::move(columns)) {
+    set_polling(true);
+}
+
+Table::Table(std::vector<TableColumn> columns, std::function<size_t()> row_count, std::function<std::string(size_t row, size_t column)> cell)
+    : source(std::make_shared<FunctionTableSource>(std::move(row_count), std::move(cell))), columns(std::move(columns)) {
+    set_polling(true);
+}
+
+Table& Table::set_style(const TableStyle& s) {
+    style = s;
+    styles_interned = false;
+    invalidate_layout(); // the gap counts towards the preferred width
+    return *this;
+}
+
+Table& Table::set_scrollbar_enabled(bool enabled) {
+    scrollbar_enabled = enabled;
+    mark_dirty();
+    return *this;
+}
+
+void Table::scroll_up(size_t amount) {
+    scroll_row -= std::min(scroll_row, amount);
+    mark_dirty();
+}
+
+void Table::scroll_down(size_t amount) {
+    scroll_row += amount; // Clamping is handled in render()
+    mark_dirty();
+}
+
+void Table::scroll_left(size_t amount) {
+    first_column -= std::min(first_column, amount);
+    mark_dirty();
+}
+
+void Table::scroll_right(size_t amount) {
+    if (columns.empty()) return;
+    first_column = std::min(first_column + amount, columns.size() - 1);
+    mark_dirty();
+}
+
+void Table::scroll_to_row(size_t index) {
+    reveal_row = index;
+    mark_dirty();
+}
+
+bool Table::poll() {
+    const size_t rows = source->row_count();
+    if (rows == drawn_rows && source->generation() == drawn_generation) return false;
+    if (rows != drawn_rows) invalidate_layout(); // the preferred height is the row count
+    return true;
+}
+
+long long Table::row_at(int mouse_x, int mouse_y) const {
+    if (!contains(mouse_x, mouse_y) || drawn_count == 0) return -1;
+    int line = (mouse_y - 1) - first_drawn_y;
+    if (line < 0 || (size_t)line >= drawn_count) return -1;
+    return (long long)(first_drawn + line);
+}
+
+int Table::get_preferred_height(int width) const {
+    return (int)std::min<size_t>(source->row_count() + 1, INT_MAX);
+}
+
+int Table::get_preferred_width() const {
+    long long total = 0;
+    for (size_t i = 0; i < columns.size(); ++i) {
+        const TableColumn& column = columns[i];
+        if (column.width != TableColumn::AUTO) total += std::max(column.width, 0);
+        else if (i < widths.size() && widths[i].width > 0) total += widths[i].width;
+        else total += std::clamp(unicode::display_width(column.title), std::max(column.min_width, 0), std::max(column.max_width, column.min_width));
+    }
+    if (!columns.empty()) total += (long long)std::max(style.column_gap, 0) * (columns.size() - 1);
+    return (int)std::min<long long>(total, INT_MAX);
+}
+
+void Table::intern_styles() {
+    if (styles_interned) return;
+    intern_style(style.header_style, header_id, header_bg_id);
+    intern_style(style.cell_style, cell_id, cell_bg_id);
+    intern_style(style.stripe_style, stripe_id, stripe_bg_id);
+    styles_interned = true;
+}
+
+// Width of `column` with rows [first_row, end_row) on screen. Only rows that were not part
+// of the last measured run are read.
+int Table::column_width(size_t column, size_t first_row, size_t end_row) {
+    const TableColumn& def = columns[column];
+    ColumnCache& cache = widths[column];
+    if (def.width != TableColumn::AUTO) {
+        cache.width = std::max(def.width, 0);
+        return cache.width;
+    }
+
+    const int lo = std::max(def.min_width, 0);
+    const int hi = std::max(def.max_width, lo);
+    auto measure_rows = [&](size_t begin, size_t end) {
+        for (size_t row = begin; row < end && cache.content < hi; ++row) {
+            cache.content = std::max(cache.content, unicode::display_width(source->cell(row, column)));
+        }
+    };
+
+    if (first_row < end_row) {
+        if (cache.measured_begin == cache.measured_end || end_row < cache.measured_begin || first_row > cache.measured_end) {
+            measure_rows(first_row, end_row);
+            cache.measured_begin = first_row;
+            cache.measured_end = end_row;
+        }
+        else {
+            measure_rows(first_row, cache.measured_begin);
+            measure_rows(cache.measured_end, end_row);
+            cache.measured_begin = std::min(cache.measured_begin, first_row);
+            cache.measured_end = std::max(cache.measured_end, end_row);
+        }
+    }
+
+    cache.width = std::clamp(std::max(cache.content, unicode::display_width(def.title)), lo, hi);
+    return cache.width;
+}
+
+void Table::render(ScreenBuffer& buffer, int x, int y, int w, int h) {
+    Component::render(buffer, x, y, w, h);
+    drawn_count = 0;
+    const size_t rows = source->row_count();
+    const std::uint64_t generation = source->generation();
+    drawn_rows = rows;
+    drawn_generation = generation;
+    if (generation != widths_generation || widths.size() != columns.size()) {
+        widths.assign(columns.size(), ColumnCache());
+        widths_generation = generation;
+    }
+    if (w <= 0 || h <= 0) return;
+
+    const size_t body_h = (size_t)(h - 1);
+    const bool is_scrollable = rows > body_h;
+    const int content_w = w - ((scrollbar_enabled && is_scrollable) ? 1 : 0);
+    if (content_w <= 0) return;
+
+    // Keep the requested row on screen, then clamp.
+    if (reveal_row < rows && body_h > 0) {
+        if (reveal_row < scroll_row) scroll_row = reveal_row;
+        else if (reveal_row >= scroll_row + body_h) scroll_row = reveal_row - body_h + 1;
+    }
+    reveal_row = SIZE_MAX;
+    const size_t max_scroll = is_scrollable ? rows - body_h : 0;
+    scroll_row = std::min(scroll_row, max_scroll);
+    if (!columns.empty()) first_column = std::min(first_column, columns.size() - 1);
+
+    // A parent may hand us more height than it shows (a List does). The header then sticks
+    // to the top of what is visible, over the rows that would be there.
+    const RowClip visible_rows = buffer.row_clip();
+    const int clip_top = std::max(y, visible_rows.top);
+    const int clip_bottom = std::min(y + h, visible_rows.bottom);
+    if (clip_top >= clip_bottom) return;
+    intern_styles();
+
+    const int body_top = clip_top + 1;
+    const size_t first = scroll_row + (size_t)(body_top - (y + 1));
+    const size_t count = (first < rows && body_top < clip_bottom) ? std::min(rows - first, (size_t)(clip_bottom - body_top)) : 0;
+
+    buffer.fill_rect(x, clip_top, content_w, 1, { glyph::SPACE, header_bg_id });
+    for (size_t i = 0; i < count; ++i) {
+        const bool stripe = style.striped && (first + i) % 2 == 1;
+        buffer.fill_rect(x, body_top + (int)i, content_w, 1, { glyph::SPACE, stripe ? stripe_bg_id : cell_bg_id });
+    }
+
+    // Columns are laid out left to right from the first one on screen, and measured (only
+    // over the visible rows) as they are reached, so columns off screen cost nothing.
+    const int gap = std::max(style.column_gap, 0);
+    int cx = 0;
+    for (size_t c = first_column; c < columns.size() && cx < content_w; ++c) {
+        const int cw = column_width(c, first, first + count);
+        const int visible = std::min(cw, content_w - cx);
+        if (visible > 0) {
+            const TableColumn& column = columns[c];
+            draw_cell(buffer, x + cx, clip_top, cw, visible, column.title, column.alignment, header_id);
+            for (size_t i = 0; i < count; ++i) {
+                const bool stripe = style.striped && (first + i) % 2 == 1;
+                draw_cell(buffer, x + cx, body_top + (int)i, cw, visible, source->cell(first + i, c), column.alignment, stripe ? stripe_id : cell_id);
+            }
+        }
+        cx += cw + gap;
+    }
+    first_drawn = first;
+    first_drawn_y = body_top;
+    drawn_count = count;
+
+    if (scrollbar_enabled && is_scrollable && body_h > 0) {
+        const StyleId track_style = StyleRegistry::RESET_ID;
+        const StyleId thumb_style = StyleRegistry::intern(ansi::INVERSE);
+        const int bar_x = x + content_w;
+        const int bar_h = (int)body_h;
+        // Rows above body_top are hidden under the sticky header, and so is that part of the bar.
+        auto fill_bar = [&](int top, int size, const Cell& cell) {
+            const int from = std::max(top, body_top);
+            buffer.fill_rect(bar_x, from, 1, top + size - from, cell);
+        };
+        fill_bar(y + 1, bar_h, { glyph::from_utf8(u8"│"), track_style });
+
+        int thumb_size = (int)std::max<long long>(1, (long long)bar_h * bar_h / (long long)rows);
+        int thumb_pos = max_scroll > 0 ? (int)((long double)scroll_row * (bar_h - thumb_size) / max_scroll) : 0;
+        fill_bar(y + 1 + thumb_pos, thumb_size, { glyph::from_utf8(u8"█"), thumb_style });
+    }
+}
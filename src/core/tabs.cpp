@@ -1,9 +1,22 @@
 #include "../include/core/tabs.hpp"
+#include "../include/core/unicode.hpp"
+#include <algorithm>
+
+// The label styles are full TextStyles, the background comes from TabsStyle::bg.
+static std::string label_ansi(const TextStyle& ts)
+{
+    std::string result = ts.color;
+    if (ts.bold) result += ansi::BOLD;
+    if (ts.underline) result += ansi::UNDERLINE;
+    if (ts.italic) result += ansi::ITALIC;
+    return result;
+}
 
 void Tabs::change_tab(int tab_idx)
 {
-    if(tab_idx >= 0 && tab_idx < tabs.size()){
+    if(tab_idx >= 0 && tab_idx < tabs.size() && tab_idx != current_tab_idx){
         current_tab_idx=tab_idx;
+        mark_dirty();
     }
 }
 
@@ -11,6 +24,7 @@ void Tabs::next_tab()
 {
     if(current_tab_idx+1 < tabs.size()){
         current_tab_idx++;
+        mark_dirty();
     }
 }
 
@@ -18,6 +32,7 @@ void Tabs::previous_tab()
 {
     if(current_tab_idx-1 > 0){
         current_tab_idx--;
+        mark_dirty();
     }
 }
 
@@ -31,6 +46,11 @@ void Tabs::handle_mouse_input(int mouse_x, int mouse_y) {
 }
 
 
+Cell Tabs::backdrop() const
+{
+    if (style.bg.empty()) return Component::backdrop();
+    return { glyph::SPACE, StyleRegistry::intern(style.bg) };
+}
 
 void Tab::render(ScreenBuffer &buffer, int x, int y, int w, int h)
 {
@@ -48,55 +68,60 @@ void Tabs::render(ScreenBuffer& buffer, int x, int y, int w, int h) {
 
     const std::string full_bg = style.bg;
     const auto& chars = style.border_chars;
+    const StyleId frame_style = StyleRegistry::intern(style.inactive_label_style.color + full_bg);
+    const StyleId active_style = StyleRegistry::intern(label_ansi(style.active_label_style) + full_bg);
+    const StyleId inactive_style = StyleRegistry::intern(label_ansi(style.inactive_label_style) + full_bg);
+    const Glyph v = glyph::from_utf8(chars.v);
+    const Glyph hz = glyph::from_utf8(chars.h);
 
     if (w < 2 || h < 2) return;
 
     // background
-    if (!style.bg.empty()) {
-        for (int i = 0; i < h; ++i)
-            for (int j = 0; j < w; ++j)
-                buffer.set_cell(x + j, y + i, " ", full_bg);
-    }
-
-    // vertical edges
-    for (int i = 1; i < h - 1; ++i) {
-        buffer.set_cell(x, y + i, chars.v, style.default_fg + full_bg);
-        buffer.set_cell(x + w - 1, y + i, chars.v, style.default_fg + full_bg);
-    }
+    if (!style.bg.empty())
+        buffer.fill_rect(x, y, w, h, { glyph::SPACE, StyleRegistry::intern(full_bg) });
 
-    // horizontal bottom
-    for (int j = 1; j < w - 1; ++j)
-        buffer.set_cell(x + j, y + h - 1, chars.h, style.default_fg + full_bg);
+    // top, bottom and side edges (the label strip overwrites part of the top one)
+    buffer.fill_rect(x + 1, y, w - 2, 1, { hz, frame_style });
+    buffer.fill_rect(x + 1, y + h - 1, w - 2, 1, { hz, frame_style });
+    buffer.fill_rect(x, y + 1, 1, h - 2, { v, frame_style });
+    buffer.fill_rect(x + w - 1, y + 1, 1, h - 2, { v, frame_style });
 
     // corners
-    buffer.set_cell(x, y, chars.tl, style.default_fg + full_bg);
-    buffer.set_cell(x + w - 1, y, chars.tr, style.default_fg + full_bg);
-    buffer.set_cell(x, y + h - 1, chars.bl, style.default_fg + full_bg);
-    buffer.set_cell(x + w - 1, y + h - 1, chars.br, style.default_fg + full_bg);
+    buffer.set_cell(x, y, glyph::from_utf8(chars.tl), frame_style);
+    buffer.set_cell(x + w - 1, y, glyph::from_utf8(chars.tr), frame_style);
+    buffer.set_cell(x, y + h - 1, glyph::from_utf8(chars.bl), frame_style);
+    buffer.set_cell(x + w - 1, y + h - 1, glyph::from_utf8(chars.br), frame_style);
 
-    // Labels 
+    // Labels, written straight into the top row between the corners
+    CellSpan strip = buffer.span(x + 1, y, w - 2);
     int col = x + 1;
+    const int strip_end = x + w - 1;
+    auto put = [&](Glyph g, StyleId s) {
+        int k = col - (x + 1) - strip.clipped_left;
+        if (k >= 0 && k < strip.size) strip[k] = { g, s };
+        col++;
+    };
 
-    if (col < x + w - 1)
-        buffer.set_cell(col++, y, chars.v, style.default_fg + full_bg);
+    if (col < strip_end)
+        put(v, frame_style);
 
     for (size_t i = 0; i < tabs.size(); ++i) {
-        std::string label = " " + tabs[i]->get_label() + " ";
-        std::string tab_style = (i == current_tab_idx)
-            ? style.active_fg + full_bg
-            : style.default_fg + full_bg;
+        const std::string& label = tabs[i]->get_label();
+        StyleId tab_style = (i == current_tab_idx) ? active_style : inactive_style;
 
         int label_start = col;
+        int label_len = std::min(unicode::display_width(label) + 2, strip_end - col);
 
-        for (char ch : label) {
-            if (col < x + w - 1)
-                buffer.set_cell(col++, y, std::string(1, ch), tab_style);
-        }
+        // A space, the label, a space, cut off where the strip ends.
+        CellSpan label_span = buffer.span(col, y, label_len);
+        label_span.fill({ glyph::SPACE, tab_style });
+        unicode::draw_text(label_span, label, tab_style, 1);
+        col += std::max(label_len, 0);
 
         int label_end = col;
 
-        if (col < x + w - 1)
-            buffer.set_cell(col++, y, chars.v, style.default_fg + full_bg);
+        if (col < strip_end)
+            put(v, frame_style);
 
         tabs[i]->last_x = label_start;
         tabs[i]->last_y = y;
@@ -104,9 +129,6 @@ void Tabs::render(ScreenBuffer& buffer, int x, int y, int w, int h) {
         tabs[i]->last_h = 1;
     }
 
-    for (; col < x + w - 1; ++col)
-        buffer.set_cell(col, y, chars.h, style.default_fg + full_bg);
-
     if (!tabs.empty()) {
         int innerX = x + 1;
         int innerY = y + 1;
@@ -1,5 +1,7 @@
 #include "core/terminal.hpp"
 #include "core/ansi.hpp"
+#include "core/input_parser.hpp"
+#include "core/output_sink.hpp"
 #include <iostream>
 #include <string>
 #include <csignal>
@@ -11,15 +13,41 @@
 #else
 #include <unistd.h>
 #include <termios.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <cerrno>
+#include <chrono>
 #endif
 
-static int last_mouse_btn = -1;
-static int last_mouse_x = -1;
-static int last_mouse_y = -1;
-static bool mouse_pressed_pending = false;
+static kontra::terminal::MouseTracking mouse_tracking = kontra::terminal::MouseTracking::ALL_MOTION;
+static bool bracketed_paste = false;
+
+// Keeps partial escape sequences (and the mouse press waiting for its release) between reads.
+static InputParser input_parser;
+
+// Last known terminal size, refreshed lazily after wait() saw a resize.
+static std::pair<int, int> cached_size;
+static bool size_stale = true;
 
 namespace kontra::terminal
 {
+    void set_mouse_tracking(MouseTracking mode) {
+        mouse_tracking = mode;
+    }
+
+    void set_bracketed_paste(bool enabled) {
+        bracketed_paste = enabled;
+    }
+
+    // SGR (1006) coordinates plus either any-motion (1003) or button-motion (1002) tracking.
+    static const char* mouse_enable_sequence() {
+        return mouse_tracking == MouseTracking::BUTTONS ? "\033[?1002h\033[?1006h" : "\033[?1003h\033[?1006h";
+    }
+
+    static const char* mouse_disable_sequence() {
+        return "\033[?1002l\033[?1003l\033[?1006l";
+    }
+
     void handle_signal(int signal_num) {
         if (signal_num == SIGINT) {
             shutdown();
@@ -45,72 +73,90 @@ namespace kontra::terminal
         SetConsoleMode(h_in, new_in_mode);
         SetConsoleMode(h_out, new_out_mode);
         ansi::hide_cursor();
-        std::cout << "\033[?1003h\033[?1006h" << std::flush;
+        std::cout << mouse_enable_sequence() << (bracketed_paste ? ansi::ENABLE_BRACKETED_PASTE : "") << std::flush;
     }
 
     void shutdown() {
-        std::cout << "\033[?1003l\033[?1006l" << std::flush;
+        OutputSink::close_active();
+        std::cout.clear();
+        std::cout << mouse_disable_sequence() << (bracketed_paste ? ansi::DISABLE_BRACKETED_PASTE : "") << std::flush;
         ansi::show_cursor();
         SetConsoleMode(GetStdHandle(STD_INPUT_HANDLE), original_in_mode);
         SetConsoleMode(GetStdHandle(STD_OUTPUT_HANDLE), original_out_mode);
     }
 
+    static HANDLE wake_event() {
+        static HANDLE event = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+        return event;
+    }
+
+    WakeReasons wait(int timeout_ms, bool want_output) {
+        // Console writes block until done, so there is never anything to wait for on output.
+        (void)want_output;
+
+        // The console has no SIGWINCH, so never sleep longer than this and
+        // report the timeout as a possible resize for the caller to check.
+        constexpr DWORD resize_poll_ms = 100;
+        DWORD timeout = (timeout_ms < 0 || (DWORD)timeout_ms > resize_poll_ms) ? resize_poll_ms : (DWORD)timeout_ms;
+
+        WakeReasons reasons;
+        if (_kbhit()) {
+            reasons.input = true;
+            return reasons;
+        }
+
+        HANDLE handles[2] = { GetStdHandle(STD_INPUT_HANDLE), wake_event() };
+        DWORD result = WaitForMultipleObjects(2, handles, FALSE, timeout);
+        if (result == WAIT_OBJECT_0) reasons.input = _kbhit() != 0;
+        else if (result == WAIT_OBJECT_0 + 1) reasons.wakeup = true;
+        else if (result == WAIT_TIMEOUT && timeout_ms != (int)timeout) reasons.resize = true;
+        if (reasons.resize) size_stale = true;
+        return reasons;
+    }
+
+    void wake() {
+        SetEvent(wake_event());
+    }
+
     void read_input_events(std::vector<InputEvent> &events) {
+        size_t first = events.size();
         while (_kbhit()) {
             int c = _getch();
 
+            // Inside a bracketed paste every byte is text, whatever it looks like.
+            if (input_parser.in_paste()) {
+                input_parser.feed(static_cast<char>(c), events);
+                continue;
+            }
+
             if (c == 224 || c == 0) { 
                 int c2 = _getch();
                 switch (c2) {
-                    case 72: events.push_back({EventType::KEY_UP}); continue;
-                    case 80: events.push_back({EventType::KEY_DOWN}); continue;
-                    case 75: events.push_back({EventType::KEY_LEFT}); continue;
-                    case 77: events.push_back({EventType::KEY_RIGHT}); continue;
+                    case 72: events.push_back(InputEvent::keyboard(EventType::KEY_UP)); continue;
+                    case 80: events.push_back(InputEvent::keyboard(EventType::KEY_DOWN)); continue;
+                    case 75: events.push_back(InputEvent::keyboard(EventType::KEY_LEFT)); continue;
+                    case 77: events.push_back(InputEvent::keyboard(EventType::KEY_RIGHT)); continue;
                 }
                 continue;
             }
             
             switch (c) {
-                case 13: events.push_back({EventType::KEY_ENTER}); continue;
-                case 8:  events.push_back({EventType::KEY_BACKSPACE}); continue;
+                case 13: events.push_back(InputEvent::keyboard(EventType::KEY_ENTER)); continue;
+                case 8:  events.push_back(InputEvent::keyboard(EventType::KEY_BACKSPACE)); continue;
                 case 27:
-                    if (_kbhit()) { 
-                        if (_getch() == '[') {
-                             if (_kbhit() && _getch() == '<') {
-                                std::string buffer;
-                                char next_char;
-                                while(_kbhit() && (next_char = _getch()) != 'M' && next_char != 'm') {
-                                    buffer += next_char;
-                                }
-                                int btn, x, y;
-                                if (sscanf(sequence.c_str(), "%d;%d;%d", &btn, &x, &y) == 3) {
-                                    char type = buffer[end_m]; 
-
-                                    if (btn == 64) { events.push_back({ EventType::MOUSE_SCROLL_UP, 0, x, y }); }
-                                    else if (btn == 65) { events.push_back({ EventType::MOUSE_SCROLL_DOWN, 0, x, y }); }
-
-                                    else if (type == 'M') {
-                                        last_mouse_btn = btn;
-                                        last_mouse_x = x;
-                                        last_mouse_y = y;
-                                        mouse_pressed_pending = true;
-                                    } else if (type == 'm' && mouse_pressed_pending) {
-                                        if (btn == last_mouse_btn && x == last_mouse_x && y == last_mouse_y) {
-                                            events.push_back({ EventType::MOUSE_PRESS, btn, x, y });
-                                        }
-                                        mouse_pressed_pending = false;
-                                    }
-                                }
-                                continue;
-                            }
-                        }
+                    // VT sequences (mouse reports, mostly) arrive as plain bytes, let the parser
+                    // take everything that is already waiting.
+                    input_parser.feed(static_cast<char>(c), events);
+                    while ((input_parser.pending() || input_parser.in_paste()) && _kbhit()) {
+                        input_parser.feed(static_cast<char>(_getch()), events);
                     }
-                    events.push_back({EventType::KEY_ESCAPE});
+                    input_parser.flush(events);
                     continue;
             }
             
-            events.push_back({EventType::KEY_PRESS, (char)c});
+            events.push_back(InputEvent::keyboard(EventType::KEY_PRESS, (char)c));
         }
+        InputParser::coalesce(events, first);
     }
 
 #else
@@ -119,6 +165,45 @@ namespace kontra::terminal
     // =================================================
     static struct termios orig_termios;
 
+    // Self-pipes: the SIGWINCH handler and wake() each write a byte, wait() polls the read ends.
+    static int resize_pipe[2] = { -1, -1 };
+    static int wake_pipe[2] = { -1, -1 };
+    static struct sigaction previous_winch_action;
+
+    static void handle_winch(int) {
+        int saved_errno = errno;
+        if (resize_pipe[1] != -1) {
+            char byte = 0;
+            (void)!write(resize_pipe[1], &byte, 1);
+        }
+        errno = saved_errno;
+    }
+
+    static bool open_pipe(int fds[2]) {
+        if (fds[0] != -1) return true;
+        if (pipe(fds) != 0) return false;
+        for (int i = 0; i < 2; ++i) {
+            fcntl(fds[i], F_SETFL, fcntl(fds[i], F_GETFL) | O_NONBLOCK);
+            fcntl(fds[i], F_SETFD, FD_CLOEXEC);
+        }
+        return true;
+    }
+
+    static void drain_pipe(int fd) {
+        char sink[64];
+        while (read(fd, sink, sizeof(sink)) > 0) {}
+    }
+
+    // A lone ESC and the start of an escape sequence look the same. If nothing else arrives
+    // within this long after an ESC, it was the Escape key.
+    static constexpr int escape_timeout_ms = 25;
+    static std::chrono::steady_clock::time_point last_input_at;
+
+    static int escape_timeout_left_ms() {
+        auto waited = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - last_input_at).count();
+        return waited >= escape_timeout_ms ? 0 : escape_timeout_ms - static_cast<int>(waited);
+    }
+
     void disable_raw_mode() {
         tcsetattr(STDIN_FILENO, TCSAFLUSH, &orig_termios);
     }
@@ -129,94 +214,126 @@ namespace kontra::terminal
         termios raw = orig_termios;
         raw.c_lflag &= ~(ECHO | ICANON);
         raw.c_cc[VMIN] = 0;
-        raw.c_cc[VTIME] = 1; // 100ms timeout
+        raw.c_cc[VTIME] = 0; // never block in read(), wait() does the blocking
         tcsetattr(STDIN_FILENO, TCSAFLUSH, &raw);
     }
 
     void initialize() {
         signal(SIGINT, handle_signal);
         enable_raw_mode();
+        size_stale = true;
+
+        open_pipe(wake_pipe);
+        if (open_pipe(resize_pipe)) {
+            struct sigaction action {};
+            action.sa_handler = handle_winch;
+            sigemptyset(&action.sa_mask);
+            action.sa_flags = SA_RESTART;
+            sigaction(SIGWINCH, &action, &previous_winch_action);
+        }
+
         ansi::hide_cursor();
-        std::cout << "\033[?1003h\033[?1006h" << std::flush;
+        std::cout << mouse_enable_sequence() << (bracketed_paste ? ansi::ENABLE_BRACKETED_PASTE : "") << std::flush;
     }
 
     void shutdown() {
-        std::cout << "\033[?1003l\033[?1006l" << std::flush;
+        // Whatever frame is still queued goes out first, and stdout has to be blocking again
+        // before the sequences below are written, or they can fail with EAGAIN. A std::cout
+        // write that already hit EAGAIN during the run left cout failed, and a failed stream
+        // drops everything, so reset it too.
+        OutputSink::close_active();
+        std::cout.clear();
+        std::cout << mouse_disable_sequence() << (bracketed_paste ? ansi::DISABLE_BRACKETED_PASTE : "") << std::flush;
         ansi::show_cursor();
+        if (resize_pipe[0] != -1) {
+            sigaction(SIGWINCH, &previous_winch_action, nullptr);
+        }
         disable_raw_mode();
     }
 
-    void read_input_events(std::vector<InputEvent> &events) {
-        char c_in[64]; 
-        int nread = read(STDIN_FILENO, &c_in, sizeof(c_in));
+    WakeReasons wait(int timeout_ms, bool want_output) {
+        pollfd fds[4] = {
+            { STDIN_FILENO, POLLIN, 0 },
+            { resize_pipe[0], POLLIN, 0 },
+            { wake_pipe[0], POLLIN, 0 },
+            { want_output ? STDOUT_FILENO : -1, POLLOUT, 0 }, // poll skips negative fds
+        };
 
-        if (nread <= 0) return;
+        // Half a sequence is waiting for the rest; wake up in time to flush it as a lone ESC.
+        bool escape_pending = input_parser.pending();
+        if (escape_pending) {
+            int left = escape_timeout_left_ms();
+            if (timeout_ms < 0 || left < timeout_ms) timeout_ms = left;
+        }
 
-        std::string buffer(c_in, nread);
-        size_t pos = 0;
+        WakeReasons reasons;
+        int ready = poll(fds, 4, timeout_ms);
+        if (ready <= 0) {
+            // timeout, or EINTR from a signal we dont care about
+            reasons.input = escape_pending && escape_timeout_left_ms() == 0;
+            return reasons;
+        }
 
-        while (pos < buffer.length()) {
-            char current_char = buffer[pos];
+        reasons.input = (fds[0].revents & (POLLIN | POLLHUP)) != 0;
+        if (fds[1].revents & POLLIN) {
+            drain_pipe(resize_pipe[0]);
+            reasons.resize = true;
+            size_stale = true;
+        }
+        if (fds[2].revents & POLLIN) {
+            drain_pipe(wake_pipe[0]);
+            reasons.wakeup = true;
+        }
+        reasons.output = (fds[3].revents & (POLLOUT | POLLERR | POLLHUP)) != 0;
+        return reasons;
+    }
 
-            switch (current_char) {
-                case 10: // Enter 
-                    events.push_back({EventType::KEY_ENTER});
-                    pos++;
-                    continue; 
-                case 127: // Backspace 
-                    events.push_back({EventType::KEY_BACKSPACE});
-                    pos++;
-                    continue;
-                case 27: 
-                    if (pos + 1 < buffer.length() && buffer[pos + 1] == '[') {
-                        // Arrow Keys: \033[A, \033[B, \033[C, \033[D
-                        if (pos + 2 < buffer.length() && buffer[pos + 2] >= 'A' && buffer[pos + 2] <= 'D') {
-                            switch (buffer[pos + 2]) {
-                                case 'A': events.push_back({EventType::KEY_UP}); break;
-                                case 'B': events.push_back({EventType::KEY_DOWN}); break;
-                                case 'C': events.push_back({EventType::KEY_RIGHT}); break;
-                                case 'D': events.push_back({EventType::KEY_LEFT}); break;
-                            }
-                            pos += 3;
-                            continue;
-                        }
-                        // SGR Mouse Event
-                        if (pos + 2 < buffer.length() && buffer[pos + 2] == '<') {
-                            size_t end_m = buffer.find_first_of("mM", pos + 3);
-                            if (end_m != std::string::npos) {
-                                std::string sequence = buffer.substr(pos + 3, end_m - (pos + 3));
-                                int btn, x, y;
-                                if (sscanf(sequence.c_str(), "%d;%d;%d", &btn, &x, &y) == 3) {
-                                    char type = buffer[end_m]; 
-
-                                    if (btn == 64) { events.push_back({ EventType::MOUSE_SCROLL_UP, 0, x, y }); }
-                                    else if (btn == 65) { events.push_back({ EventType::MOUSE_SCROLL_DOWN, 0, x, y }); }
-
-                                    else if (type == 'M') {
-                                        last_mouse_btn = btn;
-                                        last_mouse_x = x;
-                                        last_mouse_y = y;
-                                        mouse_pressed_pending = true;
-                                    } else if (type == 'm' && mouse_pressed_pending) {
-                                        if (btn == last_mouse_btn && x == last_mouse_x && y == last_mouse_y) {
-                                            events.push_back({ EventType::MOUSE_PRESS, btn, x, y });
-                                        }
-                                        mouse_pressed_pending = false;
-                                    }
-                                }
-                                pos = end_m + 1; 
-                                continue;
-                            }
-                        }
-                    }
-                    events.push_back({EventType::KEY_ESCAPE});
-                    pos++;
-                    continue;
-            }
+    void wake() {
+        if (wake_pipe[1] != -1) {
+            char byte = 0;
+            (void)!write(wake_pipe[1], &byte, 1);
+        }
+    }
 
-            events.push_back({EventType::KEY_PRESS, current_char});
-            pos++;
+    void read_input_events(std::vector<InputEvent> &events) {
+        char chunk[4096];
+        size_t first = events.size();
+        bool got_input = false;
+        while (true) {
+            ssize_t nread = read(STDIN_FILENO, chunk, sizeof(chunk));
+            if (nread <= 0) break;
+            input_parser.feed(chunk, static_cast<size_t>(nread), events);
+            got_input = true;
+            if (static_cast<size_t>(nread) < sizeof(chunk)) break;
+        }
+
+        if (got_input) {
+            last_input_at = std::chrono::steady_clock::now();
+        }
+        else if (input_parser.pending() && escape_timeout_left_ms() == 0) {
+            // Nothing followed the ESC in time, so it really was the Escape key.
+            input_parser.flush(events);
         }
+
+        // With any-motion tracking a mouse wiggle is dozens of reports; the app only needs the last one.
+        InputParser::coalesce(events, first);
     }
 #endif
+
+    bool synchronized_output_supported() {
+        int report = input_parser.synchronized_output_report();
+        return report == 1 || report == 2; // set or reset, both mean the terminal knows the mode
+    }
+
+    std::pair<int, int> size() {
+#ifndef _WIN32
+        // Without the SIGWINCH pipe there is nothing telling us about resizes, so always ask.
+        if (resize_pipe[0] == -1) size_stale = true;
+#endif
+        if (size_stale) {
+            cached_size = ansi::get_terminal_size();
+            size_stale = false;
+        }
+        return cached_size;
+    }
 }
@@ -1,6 +1,7 @@
 #include "core/text.hpp"
 #include "core/ansi.hpp"
 #include "core/screen_buffer.hpp"
+#include "core/unicode.hpp"
 #include <string>
 #include <vector>
 #include <algorithm>
@@ -10,89 +11,162 @@
 #undef max
 #endif
 
-std::vector<std::string> wrap_text(const std::string& text, int width) {
-    if (width <= 0) {
-        return { text }; 
+const std::string& Text::current_text() const {
+    if (text && content_epoch != Component::frame_epoch) {
+        content_epoch = Component::frame_epoch;
+        std::string value = text();
+        if (value != content) {
+            content = std::move(value);
+            content_generation++;
+            const_cast<Text*>(this)->invalidate_layout();
+        }
     }
+    return content;
+}
 
-    std::vector<std::string> lines;
-    std::string current_line;
-    std::string word;
-
-    for (char c : text) {
-        if (c == '\n') {
-            current_line += word;
-            lines.push_back(current_line);
-            current_line.clear();
-            word.clear();
-            continue;
-        }
+// Word wraps the text into rows of at most `width` columns. Rows break at the last space
+// that fits (the space itself is dropped), words longer than a row are cut between clusters,
+// and '\n' always ends a row. The rows are only spans into `content`, so nothing is copied.
+const std::vector<Text::LineSpan>& Text::layout(int width) const {
+    const std::string& value = current_text();
+    if (layout_generation == content_generation && layout_width == width) {
+        return lines;
+    }
+    layout_generation = content_generation;
+    layout_width = width;
+
+    auto push = [&](size_t begin, size_t end) {
+        lines.push_back({ (std::uint32_t)begin, (std::uint32_t)(end - begin) });
+    };
+
+    lines.clear();
+    const size_t n = value.size();
+    size_t line_start = 0;
+    while (true) {
+        size_t eol = value.find('\n', line_start);
+        if (eol == std::string::npos) eol = n;
+        const std::string_view line(value.data(), eol);
+
+        size_t pos = line_start;
+        do {
+            // Take clusters until the next one would not fit, remembering the last space.
+            size_t end = pos;
+            size_t last_space = std::string::npos;
+            int col = 0;
+            while (end < eol) {
+                unicode::Cluster c = unicode::next_cluster(line, end);
+                if (width > 0 && col + c.width > width) break;
+                if (value[end] == ' ' || value[end] == '\t') last_space = end;
+                col += c.width;
+                end += c.length;
+            }
 
-        if (isspace(c)) {
-            current_line += word;
-            word.clear();
-            current_line += c;
-        }
-        else {
-            word += c;
-        }
+            if (end == eol) {
+                push(pos, eol);
+                break;
+            }
+            if (value[end] == ' ' || value[end] == '\t') {
+                push(pos, end); // the space that did not fit is the break
+                pos = end + 1;
+            }
+            else if (last_space != std::string::npos && last_space > pos) {
+                push(pos, last_space);
+                pos = last_space + 1;
+            }
+            else {
+                if (end == pos) end += unicode::next_cluster(line, end).length; // wider than the row
+                push(pos, end);
+                pos = end;
+            }
+        } while (pos < eol);
 
-        if (current_line.length() + word.length() > (size_t)width) {
-            lines.push_back(current_line);
-            current_line.clear();
-        }
+        if (eol == n) break;
+        line_start = eol + 1;
     }
-    current_line += word;
-    lines.push_back(current_line);
-
     return lines;
 }
 
-
 int Text::get_preferred_height(int width) const {
     if (width <= 0) return 1;
-    std::string text_value = text();
-    if (text_value.empty()) return 1;
+    return (int)layout(width).size();
+}
 
-    return wrap_text(text_value, width).size();
+int Text::get_preferred_width() const {
+    const std::string& value = current_text();
+    if (natural_width_generation != content_generation) {
+        natural_width = 0;
+        size_t line_start = 0;
+        while (line_start <= value.size()) {
+            size_t eol = value.find('\n', line_start);
+            if (eol == std::string::npos) eol = value.size();
+            natural_width = std::max(natural_width, unicode::display_width(std::string_view(value).substr(line_start, eol - line_start)));
+            line_start = eol + 1;
+        }
+        natural_width_generation = content_generation;
+    }
+    return natural_width;
 }
 
 
-void Text::render(ScreenBuffer& buffer, int x, int y, int w, int h) {
-    Component::render(buffer, x, y, w, h); 
+Text& Text::set_text(std::string_view value) {
+    text = nullptr;
+    set_polling(false);
+    if (content != value) {
+        content.assign(value.data(), value.size()); // reuses the capacity it already has
+        content_generation++;
+        invalidate_layout();
+    }
+    return *this;
+}
+
+Text& Text::set_style(const TextStyle& new_style) {
+    if (style != new_style) {
+        style = new_style;
+        style_interned = false;
+        mark_dirty();
+    }
+    return *this;
+}
+
+void Text::intern_style() const {
+    if (style_interned) return;
 
     std::string text_style = style.color + style.background_color;
     if (style.bold) text_style += ansi::BOLD;
     if (style.underline) text_style += ansi::UNDERLINE;
     if (style.italic) text_style += ansi::ITALIC;
 
-    std::string bg_only_style = style.background_color.empty()
-        ? ansi::RESET
-        : style.background_color;
-
-    std::string text_to_render = text();
+    text_style_id = StyleRegistry::intern(text_style);
+    bg_style_id = style.background_color.empty()
+        ? StyleRegistry::RESET_ID
+        : StyleRegistry::intern(style.background_color);
+    style_interned = true;
+}
 
-    int text_idx = 0;
-    for (int i = 0; i < h; ++i) { 
-        for (int j = 0; j < w; ++j) { 
-            if (text_idx < text_to_render.length()) {
-                char current_char = text_to_render[text_idx];
+bool Text::poll() {
+    current_text();
+    return content_generation != drawn_generation;
+}
 
-                if (current_char == '\n') {
-                    text_idx++;
-                    for (int k = j; k < w; ++k) {
-                        buffer.set_cell(x + k, y + i, " ", bg_only_style);
-                    }
-                    goto next_line;
-                }
+void Text::render(ScreenBuffer& buffer, int x, int y, int w, int h) {
+    Component::render(buffer, x, y, w, h); 
 
-                buffer.set_cell(x + j, y + i, std::string(1, current_char), text_style);
-                text_idx++;
-            }
-            else {
-                buffer.set_cell(x + j, y + i, " ", bg_only_style);
-            }
+    const std::string_view value = current_text();
+    drawn_generation = content_generation;
+    if (w <= 0) return;
+    intern_style();
+    const std::vector<LineSpan>& rows = layout(w);
+
+    for (int i = 0; i < h; ++i) {
+        CellSpan row = buffer.span(x, y + i, w);
+        int k = 0;
+        if (i < (int)rows.size()) {
+            const LineSpan& line = rows[i];
+            k = unicode::draw_text(row, value.substr(line.begin, line.length), text_style_id);
+            k = std::max(k - row.clipped_left, 0);
+        }
+        for (; k < row.size; ++k) {
+            row[k] = { glyph::SPACE, bg_style_id };
         }
-    next_line:;
     }
 }
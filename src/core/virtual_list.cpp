@@ -0,0 +1,148 @@
+#include "core/virtual_list.hpp"
+#include "core/ansi.hpp"
+#include <algorithm>
+#include <climits>
+
+#ifdef _WIN32
+#undef min
+#undef max
+#endif
+
+namespace {
+    // The source behind the Text row constructor.
+    class TextRowSource : public VirtualListSource {
+    public:
+        TextRowSource(std::function<size_t()> count, std::function<void(Text&, size_t)> bind)
+            : count(std::move(count)), bind(std::move(bind)) {}
+
+        size_t row_count() const override { return count(); }
+        std::shared_ptr<Component> create_row() override { return std::make_shared<Text>(""); }
+        void bind_row(Component& row, size_t index) override { bind(static_cast<Text&>(row), index); }
+
+    private:
+        std::function<size_t()> count;
+        std::function<void(Text&, size_t)> bind;
+    };
+}
+
+VirtualList::VirtualList(std::shared_ptr<VirtualListSource> source)
+    : source(std::move(source)) {
+    set_polling(true);
+}
+
+VirtualList::VirtualList(std::function<size_t()> row_count, std::function<void(Text& row, size_t index)> bind_text)
+    : source(std::make_shared<TextRowSource>(std::move(row_count), std::move(bind_text))) {
+    set_polling(true);
+}
+
+VirtualList& VirtualList::set_row_height(int lines) {
+    row_height = std::max(lines, 1);
+    invalidate_layout();
+    return *this;
+}
+
+VirtualList& VirtualList::set_scrollbar_enabled(bool enabled) {
+    scrollbar_enabled = enabled;
+    mark_dirty();
+    return *this;
+}
+
+void VirtualList::scroll_up(int amount) {
+    scroll_offset = std::max(0, scroll_offset - amount);
+    mark_dirty();
+}
+
+void VirtualList::scroll_down(int amount) {
+    scroll_offset += amount; // Clamping is handled in render()
+    mark_dirty();
+}
+
+void VirtualList::scroll_to_row(size_t index) {
+    reveal_row = index;
+    mark_dirty();
+}
+
+bool VirtualList::poll() {
+    if (source->row_count() == drawn_rows) return false;
+    invalidate_layout(); // the preferred height is the row count
+    return true;
+}
+
+long long VirtualList::row_at(int mouse_x, int mouse_y) const {
+    if (!contains(mouse_x, mouse_y) || drawn_count == 0) return -1;
+    int line = (mouse_y - 1) - first_drawn_y;
+    if (line < 0) return -1;
+    size_t row = first_drawn + line / row_height;
+    if (row >= first_drawn + drawn_count) return -1;
+    return (long long)row;
+}
+
+int VirtualList::get_preferred_height(int width) const {
+    size_t rows = source->row_count();
+    return (int)std::min<size_t>(rows * row_height, INT_MAX);
+}
+
+void VirtualList::render(ScreenBuffer& buffer, int x, int y, int w, int h) {
+    Component::render(buffer, x, y, w, h);
+    drawn_count = 0;
+    const size_t rows = source->row_count();
+    drawn_rows = rows;
+    if (w <= 0 || h <= 0) return;
+
+    const long long content_h = (long long)rows * row_height;
+    const bool is_scrollable = content_h > h;
+    const int content_w = w - ((scrollbar_enabled && is_scrollable) ? 1 : 0);
+    if (content_w <= 0) return;
+
+    // Keep the requested row on screen, then clamp.
+    if (reveal_row < rows) {
+        long long top = (long long)reveal_row * row_height;
+        if (top < scroll_offset) scroll_offset = (int)top;
+        else if (top + row_height > scroll_offset + h) scroll_offset = (int)std::min<long long>(top + row_height - h, INT_MAX);
+    }
+    reveal_row = SIZE_MAX;
+    const int max_scroll = is_scrollable ? (int)std::min<long long>(content_h - h, INT_MAX) : 0;
+    scroll_offset = std::clamp(scroll_offset, 0, max_scroll);
+
+    // A parent may hand us more height than it shows (a List does), so only the lines that
+    // are both ours and visible are drawn.
+    const RowClip visible_rows = buffer.row_clip();
+    const int clip_top = std::max(y, visible_rows.top);
+    const int clip_bottom = std::min(y + h, visible_rows.bottom);
+    if (clip_top >= clip_bottom) return;
+
+    const long long first_line = (long long)scroll_offset + (clip_top - y);
+    const size_t first = (size_t)(first_line / row_height);
+    if (first >= rows) return;
+    const int first_y = clip_top - (int)(first_line % row_height);
+
+    const size_t visible = (size_t)((clip_bottom - first_y + row_height - 1) / row_height);
+    const size_t count = std::min(visible, rows - first);
+
+    // One component per row that can be on screen at once. Growing the pool changes which
+    // slot a row maps to, but every visible row is bound again below anyway.
+    while (pool.size() < visible + 1) {
+        pool.push_back(source->create_row());
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        size_t index = first + i;
+        Component& row = *pool[index % pool.size()];
+        source->bind_row(row, index);
+        row.render(buffer, x, first_y + (int)(i * row_height), content_w, row_height);
+    }
+    first_drawn = first;
+    first_drawn_y = first_y;
+    drawn_count = count;
+
+    if (scrollbar_enabled && is_scrollable) {
+        const StyleId track_style = StyleRegistry::RESET_ID;
+        const StyleId thumb_style = StyleRegistry::intern(ansi::INVERSE);
+        const int bar_x = x + content_w;
+        buffer.fill_rect(bar_x, y, 1, h, { glyph::from_utf8(u8"│"), track_style });
+
+        int thumb_size = (int)std::max<long long>(1, (long long)h * h / content_h);
+        int thumb_pos = max_scroll > 0 ? (int)((long long)scroll_offset * (h - thumb_size) / max_scroll) : 0;
+        buffer.fill_rect(bar_x, y + thumb_pos, 1, thumb_size, { glyph::from_utf8(u8"█"), thumb_style });
+    }
+}